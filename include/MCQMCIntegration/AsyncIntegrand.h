@@ -0,0 +1,192 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_ASYNC_INTEGRAND_H
+#define MCQMC_INTEGRATION_ASYNC_INTEGRAND_H
+/**
+ * @file AsyncIntegrand.h
+ *
+ * @brief Quasi Monte-Carlo integration of asynchronous integrand.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+
+namespace MCQMCIntegration {
+    /**
+     * Completion of asynchronous evaluations.
+     *
+     * An asynchronous integrand has
+     * @code
+     * void operator()(uint64_t index, const double p[],
+     *                 AsyncCompletion& completion)
+     * @endcode
+     * which starts evaluation at point @b p and returns. When the value
+     * is ready, done(index, value) or fail(index, exception) is called,
+     * from any thread, or in operator() itself. @b p is valid until
+     * then.
+     *
+     * Values are kept in a window of indexes, and taken in order of
+     * index by the driver.
+     */
+    class AsyncCompletion {
+    public:
+        /**
+         * constructor.
+         * @param[in] window number of values kept, index of done() should
+         * be less than getTaken() + window.
+         */
+        explicit AsyncCompletion(size_t window);
+
+        /**
+         * report value of evaluation.
+         * @param[in] index index of evaluation.
+         * @param[in] value value of integrand.
+         */
+        void done(uint64_t index, double value);
+
+        /**
+         * report failure of evaluation.
+         * @param[in] index index of evaluation.
+         * @param[in] error exception, std::current_exception() in catch.
+         */
+        void fail(uint64_t index, std::exception_ptr error);
+
+        /**
+         * wait for value of the next index in order, and take it.
+         * @return value of index getTaken().
+         * @throw exception reported by fail() of any index.
+         */
+        double take();
+
+        /**
+         * get number of evaluations done, which may be not taken yet.
+         * @return number of done() and fail().
+         */
+        uint64_t getCompleted();
+
+        /**
+         * wait until evaluations of indexes less than @b issued are done.
+         * @param[in] issued number of evaluations started.
+         */
+        void drain(uint64_t issued);
+
+        /**
+         * get number of values taken.
+         * @return number of values taken.
+         */
+        uint64_t getTaken() const {
+            return taken;
+        }
+
+        size_t getWindow() const {
+            return ready.size();
+        }
+    private:
+        AsyncCompletion(const AsyncCompletion&);
+        AsyncCompletion& operator=(const AsyncCompletion&);
+        std::mutex mtx;
+        std::condition_variable cond;
+        std::vector<double> values;
+        std::vector<char> ready;
+        uint64_t taken;
+        uint64_t completed;
+        std::exception_ptr error;
+    };
+
+    /*
+     * Quasi Monte-Carlo Integration of asynchronous integrand.
+     *
+     * This is for integrands which wait for external simulators. Points
+     * are started in the order of quasi_monte_carlo_integration(), and
+     * at most @b depth evaluations are in flight. Values may be done in
+     * any order, and are added in order of index, so the result is the
+     * same as quasi_monte_carlo_integration() of the synchronous
+     * integrand of the same values, and throughput is proportional to
+     * @b depth rather than latency of an evaluation.
+     *
+     * @tperm I asynchronous integrand function class, see AsyncCompletion.
+     * @tparm D DigitalNet class for Quasi Monete-Carlo integration.
+     *
+     * @param[in] N number of trials.
+     * @param[in,out] integrand asynchronous integrand.
+     * @param[in,out] digitalNet digital net class.
+     * @param[in] depth maximum number of evaluations in flight.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return MCQMCResult.
+     * @throw exception reported by fail() or thrown by integrand, after
+     * all evaluations in flight are done.
+     */
+    template<typename I, typename D>
+        MCQMCResult async_quasi_monte_carlo_integration(uint32_t N,
+                                                        I& integrand,
+                                                        D& digitalNet,
+                                                        size_t depth,
+                                                        int probability = 99)
+    {
+        uint32_t s = digitalNet.getS();
+        uint64_t max = UINT64_C(1) << digitalNet.getM();
+        uint32_t count = N == 0 ? 1 : N;
+        uint64_t total = max * count;
+        if (depth == 0) {
+            depth = 1;
+        }
+        // slow evaluation does not stop others until window is full
+        AsyncCompletion completion(depth * 4);
+        size_t window = completion.getWindow();
+        std::vector<double> points(window * s);
+        digitalNet.setDigitalShift(true);
+        digitalNet.pointInitialize();
+        OnlineVariance eachintval;
+        BlockVariance intsum;
+        uint64_t issued = 0;
+        try {
+            while (completion.getTaken() < total) {
+                while (issued < total
+                       && issued - completion.getTaken() < window
+                       && issued - completion.getCompleted() < depth) {
+                    double * p = &points[(issued % window) * s];
+                    const double * point = digitalNet.getPoint();
+                    std::copy(point, point + s, p);
+                    digitalNet.nextPoint();
+                    if (issued % max == max - 1) {
+                        digitalNet.pointInitialize();
+                    }
+                    try {
+                        integrand(issued, p, completion);
+                    } catch (...) {
+                        completion.fail(issued, std::current_exception());
+                    }
+                    issued++;
+                }
+                intsum.addData(completion.take());
+                if (completion.getTaken() % max == 0) {
+                    eachintval.addData(intsum.getMean());
+                    intsum = BlockVariance();
+                }
+            }
+        } catch (...) {
+            // evaluations in flight refer points and completion
+            completion.drain(issued);
+            throw;
+        }
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+}
+#endif // MCQMC_INTEGRATION_ASYNC_INTEGRAND_H
@@ -0,0 +1,300 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_AUTO_SELECT_H
+#define MCQMC_INTEGRATION_AUTO_SELECT_H
+/**
+ * @file AutoSelect.h
+ *
+ * @brief Selection of digital net and its size by pilot integrations.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+namespace MCQMCIntegration {
+    /**
+     * A configuration of integration and its prediction.
+     */
+    struct MCQMCCandidate {
+        /** ID of pre-defined digital net */
+        DigitalNetID id;
+        /** F2 dimension */
+        uint32_t m;
+        /** number of randomizations */
+        uint32_t N;
+        /** predicted absolute error */
+        double error;
+        /** predicted time in seconds */
+        double seconds;
+        /** fitted order of error, error is proportional to
+         * 2<sup>-rate * m</sup> */
+        double rate;
+        /** WAFOM value of the net, NaN if not available */
+        double wafom;
+        /** t-value of the net, negative if not available */
+        int64_t tvalue;
+    };
+
+    /**
+     * Result of autoSelect().
+     */
+    struct MCQMCSelection {
+        /** selected configuration */
+        MCQMCCandidate best;
+        /** true if the target is predicted to be met in the budget */
+        bool reachable;
+        /** number of integrand evaluations of pilot integrations */
+        uint64_t pilotEvaluations;
+        /** best configuration of each digital net tried */
+        std::vector<MCQMCCandidate> candidates;
+    };
+
+    /*
+     * errors of pilot integrations of a digital net.
+     */
+    struct MCQMCPilot {
+        DigitalNetID id;
+        uint32_t minM;
+        uint32_t maxM;
+        /** number of randomizations of pilot */
+        uint32_t trials;
+        /** ms[k] and errors[k] are F2 dimension and its error */
+        std::vector<uint32_t> ms;
+        std::vector<double> errors;
+        /** estimate by the largest m */
+        double value;
+        double secondsPerPoint;
+        double wafom;
+        int64_t tvalue;
+    };
+
+    /**
+     * predict the best configuration of a digital net from its pilot
+     * integrations.
+     *
+     * The order of error is fitted by least squares of log of errors of
+     * pilot, and errors of larger m are extrapolated from the largest m
+     * of pilot. Error of N randomizations is that of pilot times
+     * sqrt(trials / N).
+     * @param[in] pilot result of pilot integrations.
+     * @param[in] tolerance target and budget.
+     * @param[out] candidate the fastest configuration which meets the
+     * target in the budget, or the most accurate one in the budget. If
+     * tolerance has no budget, the most accurate one is limited to
+     * 2<sup>24</sup> evaluations.
+     * @return true if the target is met.
+     */
+    bool select_candidate(const MCQMCPilot& pilot,
+                          const MCQMCTolerance& tolerance,
+                          MCQMCCandidate * candidate);
+
+    /**
+     * better of two candidates, by time to meet the target or by error.
+     * @param[in] a candidate.
+     * @param[in] b candidate.
+     * @param[in] target true if compared by time.
+     * @return true if @b a is better than @b b.
+     */
+    bool better_candidate(const MCQMCCandidate& a, const MCQMCCandidate& b,
+                          bool target);
+
+    /**
+     * select digital net, F2 dimension and number of randomizations
+     * which reach the tolerance fastest, by pilot integrations.
+     *
+     * Pilot integrations are run for each pre-defined digital net which
+     * has dimension @b s, with tolerance.minTrials randomizations of
+     * 2<sup>m</sup> points for m from getMMin(), increasing m while the
+     * budget of the net lasts. The budget is divided equally among
+     * nets, and the share not used by a net is given to the following
+     * nets. Values of first points are reused when the base matrix of
+     * larger m has the same first rows. Digital nets which can't be read
+     * or whose first pilot exceeds the share are skipped, exceptions of
+     * the integrand are not caught.
+     *
+     * If tolerance has no target, the most accurate configuration in
+     * the budget of tolerance is selected. If the target can't be met
+     * and tolerance has no budget, the most accurate configuration of
+     * at most 2<sup>24</sup> evaluations is selected.
+     *
+     * @tperm I integrand function class
+     *
+     * @param[in,out] integrand integrand function class, which should have
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
+     * @param[in] s dimension of integration.
+     * @param[in] tolerance target and budget of the integration.
+     * @param[in] budget number of integrand evaluations of all pilot
+     * integrations.
+     * @return MCQMCSelection.
+     * @throw runtime_error when neither target nor budget is given, or
+     * no digital net is available in the budget.
+     */
+    template<typename I>
+        MCQMCSelection autoSelect(I& integrand, uint32_t s,
+                                  const MCQMCTolerance& tolerance,
+                                  uint64_t budget = UINT64_C(1) << 20)
+    {
+        if (tolerance.absolute <= 0 && tolerance.relative <= 0
+            && tolerance.maxEvaluations == 0 && tolerance.maxSeconds <= 0) {
+            //throw runtime_error("no tolerance nor budget!");
+            throw "no tolerance nor budget!";
+        }
+        const DigitalNetID ids[] = {NX, SOBOL, NXLW, SOLW,
+                                    ISOBOL_A2, ISOBOL_A3, ISOBOL_A4,
+                                    ISOBOL_A5, ISOBOL_A2_LW, ISOBOL_A3_LW,
+                                    ISOBOL_A4_LW, ISOBOL_A5_LW};
+        const size_t size = sizeof(ids) / sizeof(ids[0]);
+        std::vector<DigitalNetID> available;
+        for (size_t i = 0; i < size; i++) {
+            if (getSMin(ids[i]) <= s && s <= getSMax(ids[i])) {
+                available.push_back(ids[i]);
+            }
+        }
+        bool target = tolerance.absolute > 0 || tolerance.relative > 0;
+        uint32_t trials = std::max(tolerance.minTrials, UINT32_C(2));
+        BatchFeeder<I> feeder(integrand, s);
+        MCQMCSelection selection;
+        selection.reachable = false;
+        selection.pilotEvaluations = 0;
+        for (size_t i = 0; i < available.size(); i++) {
+            uint64_t share = (budget - selection.pilotEvaluations)
+                / (available.size() - i);
+            MCQMCPilot pilot;
+            pilot.id = available[i];
+            pilot.minM = getMMin(pilot.id, s);
+            pilot.maxM = getMMax(pilot.id, s);
+            if (tolerance.minM > pilot.minM) {
+                pilot.minM = std::min(tolerance.minM, pilot.maxM);
+            }
+            if (tolerance.maxM != 0 && tolerance.maxM < pilot.maxM) {
+                pilot.maxM = std::max(tolerance.maxM, pilot.minM);
+            }
+            pilot.trials = trials;
+            std::mt19937_64 mt(tolerance.seed);
+            std::vector<uint64_t> shifts(static_cast<size_t>(trials) * s);
+            for (size_t k = 0; k < shifts.size(); k++) {
+                shifts[k] = mt();
+            }
+            std::vector<double> sums(trials, 0.0);
+            uint64_t evaluations = 0;
+            double seconds = 0;
+            SharedDigitalNet prev;
+            for (uint32_t m = pilot.minM; m <= pilot.maxM; m++) {
+                SharedDigitalNet net;
+                try {
+                    net = DigitalNetRegistry::getInstance().get(pilot.id,
+                                                                s, m);
+                } catch (...) {
+                    // data of the net is not available
+                    break;
+                }
+                bool reuse = prev && qmc_same_prefix(*prev, *net);
+                uint64_t first = reuse ? UINT64_C(1) << (m - 1) : 0;
+                uint64_t cost = trials * ((UINT64_C(1) << m) - first);
+                if (evaluations + cost > share) {
+                    break;
+                }
+                DigitalNet<uint64_t> cursor(net);
+                std::chrono::steady_clock::time_point start
+                    = std::chrono::steady_clock::now();
+                OnlineVariance eachintval;
+                for (uint32_t r = 0; r < trials; r++) {
+                    double sum = qmc_partial_sum(feeder, cursor,
+                                                 &shifts[r * s], first,
+                                                 UINT64_C(1) << m);
+                    sums[r] = reuse ? sums[r] + sum : sum;
+                    eachintval.addData(sums[r] / std::ldexp(1.0, m));
+                }
+                std::chrono::duration<double> elapsed
+                    = std::chrono::steady_clock::now() - start;
+                seconds += elapsed.count();
+                evaluations += cost;
+                pilot.ms.push_back(m);
+                pilot.errors.push_back(
+                    eachintval.absErr(tolerance.probability));
+                pilot.value = eachintval.getMean();
+                pilot.wafom = net->getWAFOM();
+                pilot.tvalue = net->getTvalue();
+                prev = net;
+            }
+            selection.pilotEvaluations += evaluations;
+            if (pilot.ms.empty()) {
+                continue;
+            }
+            pilot.secondsPerPoint = seconds / static_cast<double>(evaluations);
+            MCQMCCandidate candidate;
+            bool reachable = select_candidate(pilot, tolerance, &candidate);
+            selection.candidates.push_back(candidate);
+            if (selection.candidates.size() == 1
+                || (reachable && !selection.reachable)
+                || (reachable == selection.reachable
+                    && better_candidate(candidate, selection.best,
+                                        target && reachable))) {
+                selection.best = candidate;
+                selection.reachable = reachable;
+            }
+        }
+        if (selection.candidates.empty()) {
+            //throw runtime_error("no digital net available!");
+            throw "no digital net available!";
+        }
+        return selection;
+    }
+
+    /**
+     * integrate by the configuration of autoSelect().
+     *
+     * @tperm I integrand function class
+     *
+     * @param[in,out] integrand integrand function class.
+     * @param[in] s dimension of integration.
+     * @param[in] tolerance target and budget of the integration.
+     * @param[in] budget number of integrand evaluations of pilot
+     * integrations.
+     * @param[out] selection result of autoSelect(), if not NULL.
+     * @return MCQMCAdaptiveResult, converged is true if the target is
+     * met.
+     * @throw runtime_error see autoSelect().
+     */
+    template<typename I>
+        MCQMCAdaptiveResult autoIntegrate(I& integrand, uint32_t s,
+                                          const MCQMCTolerance& tolerance,
+                                          uint64_t budget = UINT64_C(1) << 20,
+                                          MCQMCSelection * selection = NULL)
+    {
+        MCQMCSelection selected = autoSelect(integrand, s, tolerance,
+                                             budget);
+        const MCQMCCandidate& best = selected.best;
+        MCQMCResult r = quasi_monte_carlo_integration(best.N, integrand,
+                                                      best.id, s, best.m,
+                                                      tolerance.probability);
+        MCQMCAdaptiveResult result;
+        result.value = r.value;
+        result.error = r.error;
+        result.N = best.N;
+        result.m = best.m;
+        result.evaluations = static_cast<uint64_t>(best.N) << best.m;
+        result.converged
+            = (tolerance.absolute > 0 && r.error <= tolerance.absolute)
+            || (tolerance.relative > 0
+                && r.error <= tolerance.relative * std::fabs(r.value));
+        if (selection != NULL) {
+            *selection = selected;
+        }
+        return result;
+    }
+}
+#endif // MCQMC_INTEGRATION_AUTO_SELECT_H
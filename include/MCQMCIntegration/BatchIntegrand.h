@@ -0,0 +1,341 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_BATCH_INTEGRAND_H
+#define MCQMC_INTEGRATION_BATCH_INTEGRAND_H
+/**
+ * @file BatchIntegrand.h
+ *
+ * @brief Detection of batch integrands and buffering of points for them.
+ *
+ * An integrand function class may have, in addition to or instead of
+ * double operator()(const double p[]),
+ * @code
+ * void operator()(const double * points, size_t n, size_t stride,
+ *                 double * out);
+ * @endcode
+ * which sets out[i] to the value at i th point for i = 0 .. n - 1.
+ * Integration templates prefer this batch form, and pass points in
+ * chunks fitting in cache. Layout of points is chosen by the integrand
+ * with a static member
+ * @code
+ * static const BatchLayout batch_layout = BATCH_SOA;
+ * @endcode
+ * BATCH_AOS (default): j th coordinate of i th point is
+ * points[i * stride + j], stride is s.
+ * BATCH_SOA: j th coordinate of i th point is points[j * stride + i],
+ * stride is not less than n.
+ *
+ * Vector valued integrand, which has K values at a point, has
+ * @code
+ * void operator()(const double p[], double out[]);
+ * @endcode
+ * which sets out[0] .. out[K - 1], or batch form
+ * @code
+ * void operator()(const double * points, size_t n, size_t stride,
+ *                 double * out, size_t K);
+ * @endcode
+ * which sets out[i * K + k] to k th value at i th point. Points are
+ * laid out in the same way as above.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <inttypes.h>
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+namespace MCQMCIntegration {
+    /**
+     * Layout of points passed to batch integrand.
+     */
+    enum BatchLayout {
+        BATCH_AOS, /**< array of points */
+        BATCH_SOA  /**< array of coordinates */
+    };
+
+    /**
+     * bytes of points passed at once, about size of L1 data cache.
+     */
+    const size_t batch_chunk_bytes = 32 * 1024;
+
+    /**
+     * value is true if I has batch operator().
+     * @tparam I integrand function class.
+     */
+    template<typename I>
+        class has_batch_operator {
+        template<typename T>
+            static auto check(T * t)
+            -> decltype((*t)(static_cast<const double *>(NULL),
+                             static_cast<size_t>(0),
+                             static_cast<size_t>(0),
+                             static_cast<double *>(NULL)),
+                        std::true_type());
+        template<typename T>
+            static std::false_type check(...);
+    public:
+        static const bool value = decltype(check<I>(NULL))::value;
+    };
+
+    /**
+     * value is true if I has batch operator() of vector valued integrand.
+     * @tparam I integrand function class.
+     */
+    template<typename I>
+        class has_vector_batch_operator {
+        template<typename T>
+            static auto check(T * t)
+            -> decltype((*t)(static_cast<const double *>(NULL),
+                             static_cast<size_t>(0),
+                             static_cast<size_t>(0),
+                             static_cast<double *>(NULL),
+                             static_cast<size_t>(0)),
+                        std::true_type());
+        template<typename T>
+            static std::false_type check(...);
+    public:
+        static const bool value = decltype(check<I>(NULL))::value;
+    };
+
+    /**
+     * value is I::batch_layout if it exists, else BATCH_AOS.
+     * @tparam I integrand function class.
+     */
+    template<typename I>
+        class batch_layout_of {
+        template<typename T>
+            static std::integral_constant<BatchLayout, T::batch_layout>
+            check(T *);
+        template<typename T>
+            static std::integral_constant<BatchLayout, BATCH_AOS>
+            check(...);
+    public:
+        static const BatchLayout value = decltype(check<I>(NULL))::value;
+    };
+
+    /**
+     * number of points in a chunk of @b s dimensional points.
+     * @param[in] s dimension.
+     * @return number of points.
+     */
+    inline size_t batch_chunk_size(uint32_t s)
+    {
+        size_t n = batch_chunk_bytes / (sizeof(double) * (s == 0 ? 1 : s));
+        return n == 0 ? 1 : n;
+    }
+
+    /**
+     * Pass points to integrand and values to accumulator.
+     *
+     * This is for integrand without batch operator(), each point is
+     * evaluated when it is added.
+     * @tparam I integrand function class.
+     * @tparam batch true if I has batch operator().
+     */
+    template<typename I, bool batch = has_batch_operator<I>::value>
+        class BatchFeeder {
+    public:
+        BatchFeeder(I& integrand, uint32_t) : integrand(integrand) {
+        }
+
+        /**
+         * add a point.
+         * @tparam A accumulator, which has addData(double).
+         * @param[in] point point.
+         * @param[in,out] acc accumulator.
+         */
+        template<typename A>
+            void add(const double point[], A& acc) {
+            acc.addData(integrand(point));
+        }
+
+        /**
+         * evaluate points added and not evaluated yet.
+         * @param[in,out] acc accumulator.
+         */
+        template<typename A>
+            void flush(A&) {
+        }
+    private:
+        I& integrand;
+    };
+
+    /**
+     * Pass points to integrand and values to accumulator.
+     *
+     * This is for integrand with batch operator(). Points are stored in
+     * the layout of the integrand, and evaluated when a chunk is full or
+     * flush() is called. Values are passed to accumulator in order of
+     * points.
+     * @tparam I integrand function class.
+     */
+    template<typename I>
+        class BatchFeeder<I, true> {
+    public:
+        BatchFeeder(I& integrand, uint32_t s)
+            : integrand(integrand),
+              capacity(batch_chunk_size(s)),
+              points(capacity * s),
+              out(capacity) {
+            this->s = s;
+            used = 0;
+        }
+
+        template<typename A>
+            void add(const double point[], A& acc) {
+            if (batch_layout_of<I>::value == BATCH_SOA) {
+                for (uint32_t j = 0; j < s; j++) {
+                    points[j * capacity + used] = point[j];
+                }
+            } else {
+                for (uint32_t j = 0; j < s; j++) {
+                    points[used * s + j] = point[j];
+                }
+            }
+            used++;
+            if (used == capacity) {
+                flush(acc);
+            }
+        }
+
+        template<typename A>
+            void flush(A& acc) {
+            if (used == 0) {
+                return;
+            }
+            size_t stride = s;
+            if (batch_layout_of<I>::value == BATCH_SOA) {
+                stride = capacity;
+            }
+            integrand(&points[0], used, stride, &out[0]);
+            for (size_t i = 0; i < used; i++) {
+                acc.addData(out[i]);
+            }
+            used = 0;
+        }
+    private:
+        I& integrand;
+        uint32_t s;
+        size_t capacity;
+        size_t used;
+        std::vector<double> points;
+        std::vector<double> out;
+    };
+
+    /**
+     * Pass points to vector valued integrand and values to K
+     * accumulators.
+     *
+     * This is for integrand without batch operator().
+     * @tparam I vector valued integrand function class.
+     * @tparam batch true if I has batch operator() of vector valued
+     * integrand.
+     */
+    template<typename I, bool batch = has_vector_batch_operator<I>::value>
+        class VectorFeeder {
+    public:
+        VectorFeeder(I& integrand, uint32_t, size_t K)
+            : integrand(integrand), out(K) {
+        }
+
+        /**
+         * add a point.
+         * @tparam A array of accumulators, acc[k] has addData(double).
+         * @param[in] point point.
+         * @param[in,out] acc K accumulators.
+         */
+        template<typename A>
+            void add(const double point[], A& acc) {
+            integrand(point, &out[0]);
+            for (size_t k = 0; k < out.size(); k++) {
+                acc[k].addData(out[k]);
+            }
+        }
+
+        /**
+         * evaluate points added and not evaluated yet.
+         * @param[in,out] acc K accumulators.
+         */
+        template<typename A>
+            void flush(A&) {
+        }
+    private:
+        I& integrand;
+        std::vector<double> out;
+    };
+
+    /**
+     * Pass points to vector valued integrand and values to K
+     * accumulators.
+     *
+     * This is for integrand with batch operator(), points are buffered
+     * as BatchFeeder.
+     * @tparam I vector valued integrand function class.
+     */
+    template<typename I>
+        class VectorFeeder<I, true> {
+    public:
+        VectorFeeder(I& integrand, uint32_t s, size_t K)
+            : integrand(integrand),
+              capacity(batch_chunk_size(s)),
+              points(capacity * s),
+              out(capacity * K) {
+            this->s = s;
+            this->K = K;
+            used = 0;
+        }
+
+        template<typename A>
+            void add(const double point[], A& acc) {
+            if (batch_layout_of<I>::value == BATCH_SOA) {
+                for (uint32_t j = 0; j < s; j++) {
+                    points[j * capacity + used] = point[j];
+                }
+            } else {
+                for (uint32_t j = 0; j < s; j++) {
+                    points[used * s + j] = point[j];
+                }
+            }
+            used++;
+            if (used == capacity) {
+                flush(acc);
+            }
+        }
+
+        template<typename A>
+            void flush(A& acc) {
+            if (used == 0) {
+                return;
+            }
+            size_t stride = s;
+            if (batch_layout_of<I>::value == BATCH_SOA) {
+                stride = capacity;
+            }
+            integrand(&points[0], used, stride, &out[0], K);
+            for (size_t i = 0; i < used; i++) {
+                for (size_t k = 0; k < K; k++) {
+                    acc[k].addData(out[i * K + k]);
+                }
+            }
+            used = 0;
+        }
+    private:
+        I& integrand;
+        uint32_t s;
+        size_t K;
+        size_t capacity;
+        size_t used;
+        std::vector<double> points;
+        std::vector<double> out;
+    };
+}
+#endif // MCQMC_INTEGRATION_BATCH_INTEGRAND_H
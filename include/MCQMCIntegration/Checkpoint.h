@@ -0,0 +1,131 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_CHECKPOINT_H
+#define MCQMC_INTEGRATION_CHECKPOINT_H
+/**
+ * @file Checkpoint.h
+ *
+ * @brief Checkpoint file of Quasi Monte-Carlo integration.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/DigitalNet.h>
+#include <chrono>
+#include <string>
+
+namespace MCQMCIntegration {
+    class OnlineVariance;
+    class BlockVariance;
+
+    /**
+     * Where and how often integration state is saved.
+     *
+     * A checkpoint is written when one of intervals has passed since
+     * the last one. Zero means the interval is not used.
+     */
+    struct CheckpointConfig {
+        explicit CheckpointConfig(const std::string& path = "",
+                                  double intervalSeconds = 60) {
+            this->path = path;
+            this->intervalSeconds = intervalSeconds;
+            intervalPoints = 0;
+            removeOnFinish = true;
+        }
+        /** checkpoint file, empty means no checkpoint */
+        std::string path;
+        /** interval in seconds */
+        double intervalSeconds;
+        /** interval in number of points */
+        uint64_t intervalPoints;
+        /** remove checkpoint file when integration finishes */
+        bool removeOnFinish;
+    };
+
+    /**
+     * Checkpoint of quasi_monte_carlo_integration() with
+     * CheckpointConfig.
+     *
+     * FORMAT, all integers are 64-bit little endian:
+     * @li magic and version.
+     * @li @b N, number of randomizations.
+     * @li number of randomizations done.
+     * @li number of points done in current randomization.
+     * @li OnlineVariance of randomizations, serialized.
+     * @li BlockVariance of current randomization, serialized.
+     * @li state of digital net, see DigitalNet::saveState().
+     *
+     * The file is written to a temporary file and renamed, so that
+     * the last checkpoint is left if the process is killed while
+     * writing.
+     */
+    class Checkpoint {
+    public:
+        /**
+         * constructor.
+         * @param[in] config where and how often.
+         * @param[in] N number of randomizations of the integration.
+         */
+        Checkpoint(const CheckpointConfig& config, uint32_t N);
+
+        /**
+         * restore state from checkpoint file.
+         * @param[in,out] net digital net of the integration.
+         * @param[out] cnt number of randomizations done.
+         * @param[out] index number of points done in current
+         * randomization.
+         * @param[out] eachintval statistics of randomizations.
+         * @param[out] intsum statistics of current randomization.
+         * @return false if there is no valid checkpoint of this
+         * integration, then outputs are not changed.
+         */
+        bool restore(DigitalNet<uint64_t>& net, uint32_t * cnt,
+                     uint64_t * index, OnlineVariance& eachintval,
+                     BlockVariance& intsum);
+
+        /**
+         * count a point and check if a checkpoint should be written.
+         * @return true if save() should be called.
+         */
+        bool due() {
+            return ++points >= nextCheck && reached();
+        }
+
+        /**
+         * write checkpoint file.
+         * @param[in] net digital net of the integration.
+         * @param[in] cnt number of randomizations done.
+         * @param[in] index number of points done in current
+         * randomization.
+         * @param[in] eachintval statistics of randomizations.
+         * @param[in] intsum statistics of current randomization.
+         * @throw runtime_error when can't write file.
+         */
+        void save(const DigitalNet<uint64_t>& net, uint32_t cnt,
+                  uint64_t index, const OnlineVariance& eachintval,
+                  const BlockVariance& intsum);
+
+        /**
+         * integration has finished, remove checkpoint file if
+         * configured.
+         */
+        void finish();
+    private:
+        bool reached();
+        void reset();
+        CheckpointConfig config;
+        uint32_t N;
+        uint64_t points;
+        uint64_t nextCheck;
+        std::chrono::steady_clock::time_point last;
+    };
+}
+#endif // MCQMC_INTEGRATION_CHECKPOINT_H
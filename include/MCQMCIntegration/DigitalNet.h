@@ -26,6 +26,7 @@
 #include <string>
 #include <cerrno>
 #include <random>
+#include <memory>
 
 namespace MCQMCIntegration {
     /**
@@ -83,6 +84,39 @@ namespace MCQMCIntegration {
     uint32_t getMMin(DigitalNetID id, uint32_t s);
 
     const std::string getDigitalNetName(uint32_t index);
+
+    /**
+     * enable or disable POSIX shared memory cache of base matrix.
+     *
+     * When enabled, base matrix of pre-defined digital net is read once
+     * and published to a shared memory segment, and other DigitalNet
+     * objects of the same id, s and m, even in other processes of the
+     * same user, map the segment read only. The cache is enabled by
+     * default when environment variable DIGITAL_NET_SHM is set and not
+     * 0. Lazy mode does not use the cache.
+     * @param[in] enable true to use the cache.
+     */
+    void setSharedMemoryCache(bool enable);
+
+    /**
+     * check if shared memory cache is enabled.
+     * @return true if enabled.
+     */
+    bool getSharedMemoryCache();
+
+    /**
+     * remove shared memory segment of base matrix. Objects already
+     * mapping the segment are not affected.
+     * @param[in] id ID of pre-defined digital net.
+     * @param[in] s dimension of point set.
+     * @param[in] m F2 dimension of element of point set.
+     * @return true if removed.
+     */
+    bool removeSharedMemoryCache(DigitalNetID id, uint32_t s, uint32_t m);
+
+    class ColumnReader;
+    class PackedBase;
+
     /**
      * Digital Net class for Quasi Mote-Carlo Method.
      * This class is almost dummy.
@@ -116,6 +150,7 @@ namespace MCQMCIntegration {
         public:
             GrayIndex();
             void clear();
+            void set(uint64_t count);
             void next();
             int index();
         private:
@@ -134,6 +169,10 @@ namespace MCQMCIntegration {
          * @li 4th -       : @b s * @b m elements of 64-bit integers.
          * @li last but one: WAFOM value, optional.
          * @li last        : t-value, optional.
+         *
+         * Binary compact format written by writeCompact() is also
+         * accepted, and then the net is in compact mode.
+         * Data after the net are left in the stream.
          * @throw runtime_error when can't read from stream.
          */
         DigitalNet(std::istream& is);
@@ -145,12 +184,33 @@ namespace MCQMCIntegration {
          * @li NXLW : Niederreiter-Xing low WAFOM up to dimension 10.
          * @li SOBOL: Sobol Point Set up to dimension 21201.
          * @li SOLW : Sobol low WAFOM up to dimension 10.
+         * In lazy mode, which is effective for SOBOL and ISOBOL_A2 ..
+         * ISOBOL_A5, only the first dimensions are made at construction,
+         * and following dimensions are made chunk by chunk when they are
+         * read by getPoint() or requireDimension() is called. Coordinates
+         * of point which are not made yet are NaN only through const
+         * getPoint().
          * @param[in] id ID of pre-defined digital net.
          * @param[in] s dimension of point set, s should be 4 <= s
          * @param[in] m F2 dimension of element of point set, m should be
          * 10 <= m <= 18.
+         * @param[in] lazy make dimensions on demand.
+         */
+        DigitalNet(DigitalNetID id, uint32_t s, uint32_t m,
+                   bool lazy = false);
+
+        /**
+         * constructor sharing base matrix of @b prototype.
+         *
+         * Base matrix is not copied until one of them is scrambled.
+         * Point, digital shift and random number generator are not
+         * shared, they are initialized as a newly constructed net.
+         * @param[in] prototype digital net which has base matrix.
+         * @throw runtime_error when prototype is lazy and not all
+         * dimensions are made.
          */
-        DigitalNet(DigitalNetID id, uint32_t s, uint32_t m);
+        explicit DigitalNet(
+            const std::shared_ptr<const DigitalNet<uint64_t> >& prototype);
 
         /**
          * destructor.
@@ -164,11 +224,27 @@ namespace MCQMCIntegration {
          * @return an element of base matrix of generating point set.
          */
         uint64_t getBase(int i, int j) const {
+            if (packed != NULL) {
+                return getPackedBase(i, j);
+            }
             return base[i * s + j];
         }
 
         /**
          * get a component of a point vector.
+         * In lazy mode, the dimension is made if it is not made yet.
+         * @param[in] i get i-th component.
+         * @return a component of a point vector.
+         * @throw runtime_error when can't read data.
+         */
+        double getPoint(int i) {
+            requireDimension(i + 1);
+            return point[i];
+        }
+
+        /**
+         * get a component of a point vector, which is NaN if the
+         * dimension is not made yet.
          * @param[in] i get i-th component.
          * @return a component of a point vector.
          */
@@ -178,6 +254,18 @@ namespace MCQMCIntegration {
 
         /**
          * get a point vector.
+         * In lazy mode, all dimensions not made yet are made.
+         * @return a point vector.
+         * @throw runtime_error when can't read data.
+         */
+        const double * getPoint() {
+            requireDimension(s);
+            return point;
+        }
+
+        /**
+         * get a point vector, whose coordinates are NaN for dimensions
+         * not made yet.
          * @return a point vector.
          */
         const double * getPoint() const {
@@ -192,6 +280,27 @@ namespace MCQMCIntegration {
             return s;
         }
 
+        /**
+         * get number of dimensions which are already made.
+         * This is less than getS() only in lazy mode.
+         * @return number of dimensions already made.
+         */
+        uint32_t getMaterializedS() const {
+            return materialized;
+        }
+
+        /**
+         * make the first @b d dimensions available, in lazy mode.
+         * Coordinates of current point are also made.
+         * @param[in] d number of dimensions required.
+         * @throw runtime_error when can't read data.
+         */
+        void requireDimension(uint32_t d) {
+            if (d > materialized) {
+                materialize(d);
+            }
+        }
+
         /**
          * get F2 dimension of element of digital net.
          * @return F2 dimension of element of digital net.
@@ -216,19 +325,62 @@ namespace MCQMCIntegration {
          */
         void nextPoint();
 
+        /**
+         * skip to @b index th point of current randomization, in the
+         * order of nextPoint(). Digital shift is not changed.
+         * @param[in] index index of point, 0 <= index < 2<sup>m</sup>.
+         */
+        void setIndex(uint64_t index);
+
         void setDigitalShift(bool value) {
             digitalShift = value;
         }
+
+        /**
+         * get digital shift of current randomization.
+         * @return array of @b s elements.
+         */
+        const uint64_t * getShift() const {
+            return shift;
+        }
+
+        /**
+         * replace digital shift of current randomization, current point
+         * is also changed. Following pointInitialize() overwrites it.
+         * @param[in] shift array of @b s elements.
+         */
+        void setShift(const uint64_t shift[]);
         /**
          * set seed for random number generator for scramble.
          */
         void setSeed(uint64_t seed);
 
+        /**
+         * write state of point generation: current point, digital
+         * shift and random number generator, which is restored by
+         * restoreState(). Base matrix is not written, but its
+         * fingerprint is.
+         * @param[in,out] os output stream, should be binary mode.
+         * @throw runtime_error when point is not initialized.
+         */
+        void saveState(std::ostream& os) const;
+
+        /**
+         * restore state written by saveState() of a net of the same
+         * base matrix. Following points and digital shifts are the same
+         * as those of the saved net.
+         * @param[in,out] is input stream, should be binary mode.
+         * @return false if the state is broken or of other net, then
+         * state of this net is not changed.
+         * @throw runtime_error when can't read data in lazy mode.
+         */
+        bool restoreState(std::istream& is);
+
         /**
          * get WAFOM value if exist.
          * @return WAFOM value.
          */
-        double getWAFOM() {
+        double getWAFOM() const {
             return wafom;
         }
 
@@ -236,15 +388,49 @@ namespace MCQMCIntegration {
          * get t-value if exist.
          * @return t-value
          */
-        int64_t getTvalue() {
+        int64_t getTvalue() const {
             return tvalue;
         }
         void linearScramble();
+
+        /**
+         * change to compact mode.
+         *
+         * In compact mode, base matrix is kept bit packed, only upper
+         * @b precision bits of elements and bits which are not zero in
+         * the same row are kept. Rows are unpacked when points are
+         * generated. Precision 53 or more does not change points.
+         * @param[in] precision number of upper bits kept, 1 <= precision
+         * <= 64.
+         */
+        void setCompact(int precision = 53);
+
+        /**
+         * check if compact mode.
+         * @return true if compact mode.
+         */
+        bool isCompact() const {
+            return packed != NULL;
+        }
+
+        /**
+         * write base matrix in binary compact format, which can be read
+         * by DigitalNet(std::istream&).
+         * @param[in,out] os output stream, should be binary mode.
+         * @param[in] precision number of upper bits kept.
+         */
+        void writeCompact(std::ostream& os, int precision = 53);
     private:
         void setBase(int i, int j, uint64_t value) {
             base[i * s + j] = value;
         }
         void convertPoint();
+        uint64_t fingerprint() const;
+        void materialize(uint32_t d);
+        void allocateBase(bool clear);
+        void releaseBase();
+        void ownBase();
+        uint64_t getPackedBase(int i, int j) const;
         uint32_t s;
         uint32_t m;
         uint64_t *shift;
@@ -258,8 +444,14 @@ namespace MCQMCIntegration {
         GrayIndex grayindex;
         std::mt19937_64 mt;
         uint64_t * base;
+        // owner of base, which may be shared read only memory
+        std::shared_ptr<uint64_t> baseHolder;
+        bool baseShared;
         uint64_t * point_base;
         double * point;
+        uint32_t materialized;
+        ColumnReader * reader;
+        PackedBase * packed;
     };
 }
 #endif // MCQMC_INTEGRATION_DIGITAL_NET_H
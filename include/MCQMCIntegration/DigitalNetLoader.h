@@ -0,0 +1,123 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_DIGITAL_NET_LOADER_H
+#define MCQMC_INTEGRATION_DIGITAL_NET_LOADER_H
+/**
+ * @file DigitalNetLoader.h
+ *
+ * @brief Asynchronous loading of pre-defined Digital Nets.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/DigitalNet.h>
+#include <memory>
+#include <future>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace MCQMCIntegration {
+    /**
+     * shared pointer of 64-bit Digital Net.
+     */
+    typedef std::shared_ptr<DigitalNet<uint64_t> > DigitalNetPtr;
+
+    /**
+     * Configuration of pre-defined Digital Net.
+     */
+    struct DigitalNetConfig {
+        /** ID of pre-defined digital net. */
+        DigitalNetID id;
+        /** dimension of point set. */
+        uint32_t s;
+        /** F2 dimension of element of point set. */
+        uint32_t m;
+    };
+
+    /**
+     * load pre-defined digital net on a background thread.
+     *
+     * Exception thrown by the constructor of DigitalNet is thrown
+     * from get() of returned future.
+     * @param[in] id ID of pre-defined digital net.
+     * @param[in] s dimension of point set.
+     * @param[in] m F2 dimension of element of point set.
+     * @param[in] lazy make dimensions on demand, see DigitalNet.
+     * @return future of loaded digital net.
+     */
+    std::future<DigitalNetPtr> loadDigitalNetAsync(DigitalNetID id,
+                                                   uint32_t s,
+                                                   uint32_t m,
+                                                   bool lazy = false);
+
+    /**
+     * Load many pre-defined digital nets on background threads.
+     *
+     * Loading starts at construction. Nets can be taken in the order
+     * they become ready by next(), or individually by get().
+     * Destructor waits for all loading threads.
+     */
+    class DigitalNetWarmup {
+    public:
+        /**
+         * start loading.
+         * @param[in] configs configurations of digital nets to be loaded.
+         * @param[in] threads number of loading threads, 0 means
+         * the number of hardware threads.
+         */
+        explicit DigitalNetWarmup(const std::vector<DigitalNetConfig>& configs,
+                                  unsigned threads = 0);
+        ~DigitalNetWarmup();
+
+        /**
+         * get number of configurations.
+         * @return number of configurations.
+         */
+        size_t size() const {
+            return configs.size();
+        }
+
+        /**
+         * wait until a net which is not returned by next() yet is ready.
+         * Exception in loading is thrown here.
+         * @param[out] index index of configuration of the net.
+         * @param[out] net loaded digital net.
+         * @return false if all nets have been returned.
+         */
+        bool next(size_t * index, DigitalNetPtr * net);
+
+        /**
+         * wait until @b index th net is ready.
+         * Exception in loading is thrown here.
+         * @param[in] index index of configuration.
+         * @return loaded digital net.
+         */
+        DigitalNetPtr get(size_t index);
+    private:
+        DigitalNetWarmup(const DigitalNetWarmup&);
+        DigitalNetWarmup& operator=(const DigitalNetWarmup&);
+        void work();
+        std::vector<DigitalNetConfig> configs;
+        std::vector<DigitalNetPtr> nets;
+        std::vector<std::exception_ptr> errors;
+        std::vector<bool> done;
+        std::vector<bool> taken;
+        std::vector<std::thread> threads;
+        std::mutex mtx;
+        std::condition_variable cond;
+        size_t nextConfig;
+        size_t takenCount;
+    };
+}
+#endif // MCQMC_INTEGRATION_DIGITAL_NET_LOADER_H
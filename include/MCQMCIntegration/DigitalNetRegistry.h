@@ -0,0 +1,126 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_DIGITAL_NET_REGISTRY_H
+#define MCQMC_INTEGRATION_DIGITAL_NET_REGISTRY_H
+/**
+ * @file DigitalNetRegistry.h
+ *
+ * @brief Process-wide registry of constructed Digital Nets.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/DigitalNet.h>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <list>
+
+namespace MCQMCIntegration {
+    /**
+     * shared pointer of immutable 64-bit Digital Net.
+     */
+    typedef std::shared_ptr<const DigitalNet<uint64_t> > SharedDigitalNet;
+
+    /**
+     * Thread safe registry of pre-defined digital nets.
+     *
+     * Nets are kept up to capacity, and the least recently used net is
+     * removed when the registry is full. Returned nets are immutable,
+     * points are generated by DigitalNet objects constructed from them,
+     * which share base matrix.
+     * @code
+     * SharedDigitalNet net = DigitalNetRegistry::getInstance().get(SOBOL,
+     *                                                              10, 16);
+     * DigitalNet<uint64_t> cursor(net);
+     * @endcode
+     */
+    class DigitalNetRegistry {
+    public:
+        /**
+         * constructor.
+         * @param[in] capacity maximum number of nets kept.
+         */
+        explicit DigitalNetRegistry(size_t capacity = 16);
+
+        /**
+         * get process-wide registry.
+         * @return registry.
+         */
+        static DigitalNetRegistry& getInstance();
+
+        /**
+         * get pre-defined digital net, which is constructed if it is not
+         * in the registry.
+         * @param[in] id ID of pre-defined digital net.
+         * @param[in] s dimension of point set.
+         * @param[in] m F2 dimension of element of point set.
+         * @param[in] scramble if true, base matrix is linearly scrambled
+         * by random number generator of seed @b seed.
+         * @param[in] seed seed for scramble.
+         * @return immutable digital net.
+         * @throw runtime_error when the constructor of DigitalNet throws.
+         */
+        SharedDigitalNet get(DigitalNetID id, uint32_t s, uint32_t m,
+                             bool scramble = false, uint64_t seed = 0);
+
+        /**
+         * change capacity, nets are removed if the number of nets
+         * exceeds new capacity.
+         * @param[in] capacity maximum number of nets kept.
+         */
+        void setCapacity(size_t capacity);
+
+        /**
+         * remove all nets, counters are not cleared.
+         */
+        void clear();
+
+        size_t getCapacity();
+        size_t size();
+
+        /**
+         * @return number of get() which found the net in registry.
+         */
+        uint64_t getHits();
+
+        /**
+         * @return number of get() which constructed the net.
+         */
+        uint64_t getMisses();
+    private:
+        DigitalNetRegistry(const DigitalNetRegistry&);
+        DigitalNetRegistry& operator=(const DigitalNetRegistry&);
+        struct Key {
+            int id;
+            int bitsize;
+            uint32_t s;
+            uint32_t m;
+            bool scramble;
+            uint64_t seed;
+            bool operator<(const Key& that) const;
+        };
+        typedef std::list<Key> LRUList;
+        struct Entry {
+            SharedDigitalNet net;
+            LRUList::iterator pos;
+        };
+        void evict();
+        std::mutex mtx;
+        size_t capacity;
+        std::map<Key, Entry> entries;
+        // most recently used first
+        LRUList lru;
+        uint64_t hits;
+        uint64_t misses;
+    };
+}
+#endif // MCQMC_INTEGRATION_DIGITAL_NET_REGISTRY_H
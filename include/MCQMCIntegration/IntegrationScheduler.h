@@ -0,0 +1,214 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_INTEGRATION_SCHEDULER_H
+#define MCQMC_INTEGRATION_INTEGRATION_SCHEDULER_H
+/**
+ * @file IntegrationScheduler.h
+ *
+ * @brief Asynchronous Quasi Monte-Carlo integration jobs on thread pool.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include <future>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <map>
+
+namespace MCQMCIntegration {
+    /**
+     * Parameters of an integration job.
+     */
+    struct IntegrationConfig {
+        IntegrationConfig(DigitalNetID id, uint32_t s, uint32_t m,
+                          uint32_t N = 10, int probability = 99) {
+            this->id = id;
+            this->s = s;
+            this->m = m;
+            this->N = N;
+            this->probability = probability;
+            priority = 0;
+            seed = std::mt19937_64::default_seed;
+        }
+        /** ID of pre-defined digital net */
+        DigitalNetID id;
+        /** dimension of integration */
+        uint32_t s;
+        /** F2 dimension of digital net */
+        uint32_t m;
+        /** number of randomizations */
+        uint32_t N;
+        /** one of {95, 99, 999, 9999} */
+        int probability;
+        /** job of larger priority is done first */
+        int priority;
+        /** seed of digital shifts */
+        uint64_t seed;
+        /** observer of progress of job by submit() */
+        ProgressObserver observer;
+    };
+
+    /**
+     * Scheduler of integration jobs.
+     *
+     * submit() returns immediately with a future of the result, and
+     * the job runs on a worker of thread pool. A worker takes the job of
+     * the highest priority, and keeps the net from DigitalNetRegistry
+     * for the next job while the job of the highest priority is of the
+     * same digital net, id, s and m. Jobs of the same net run on idle
+     * workers in parallel. The result of a job is the same as
+     * quasi_monte_carlo_integration() of the config with a fresh digital
+     * net of the seed, irrespective of batching.
+     *
+     * @code
+     * ThreadPool pool;
+     * IntegrationScheduler scheduler(pool);
+     * std::future<MCQMCResult> f
+     *     = scheduler.submit(integrand, IntegrationConfig(SOBOL, 10, 16));
+     * MCQMCResult r = f.get();
+     * @endcode
+     */
+    class IntegrationScheduler {
+    public:
+        typedef uint64_t JobID;
+        typedef std::function<MCQMCResult(DigitalNet<uint64_t>& cursor)>
+        Runner;
+
+        /**
+         * constructor.
+         * @param[in,out] pool thread pool where jobs run. Should not be
+         * used by run() of other jobs of the same pool.
+         * @param[in] maxBatch maximum number of jobs a worker runs in a
+         * row with a digital net.
+         */
+        explicit IntegrationScheduler(ThreadPool& pool,
+                                      size_t maxBatch = 64);
+
+        /**
+         * cancel waiting jobs and wait for running jobs.
+         */
+        ~IntegrationScheduler();
+
+        /**
+         * submit an integration job.
+         * @tparam I integrand function class, which is copied.
+         * @param[in] integrand integrand.
+         * @param[in] config parameters.
+         * @param[out] id ID of the job, for cancel(), if not NULL.
+         * @return future of the result. It throws runtime_error if the
+         * job is cancelled before start, or exception of the job. If
+         * the job is stopped by observer of @b config or cancelled while
+         * running, it has the partial result.
+         */
+        template<typename I>
+            std::future<MCQMCResult> submit(const I& integrand,
+                                            const IntegrationConfig& config,
+                                            JobID * id = NULL) {
+            std::shared_ptr<I> copy(new I(integrand));
+            std::shared_ptr<std::atomic<bool> > stop(
+                new std::atomic<bool>(false));
+            uint32_t N = config.N;
+            int probability = config.probability;
+            ProgressObserver observer = config.observer;
+            ProgressObserver::Callback callback = observer.callback;
+            observer.callback = [stop, callback]
+                (const MCQMCProgress& progress) {
+                return !*stop && (!callback || callback(progress));
+            };
+            Runner runner = [copy, N, probability, observer]
+                (DigitalNet<uint64_t>& cursor) {
+                return quasi_monte_carlo_integration(N, *copy, cursor,
+                                                     observer, probability);
+            };
+            return submitJob(runner, config, id, stop);
+        }
+
+        /**
+         * submit a job which integrates by @b runner with a cursor of
+         * the digital net of @b config. Digital shift of the cursor is
+         * initialized by seed of @b config.
+         * @param[in] runner job.
+         * @param[in] config parameters.
+         * @param[out] id ID of the job, for cancel(), if not NULL.
+         * @return future of the result.
+         */
+        std::future<MCQMCResult> submitRunner(const Runner& runner,
+                                              const IntegrationConfig&
+                                              config,
+                                              JobID * id = NULL);
+
+        /**
+         * cancel a job.
+         *
+         * A job which is not started yet is removed. A running job of
+         * submit() stops at next report of progress, which is the end of
+         * randomization unless interval of observer is given, and
+         * returns the partial result.
+         * @param[in] id ID of the job.
+         * @return true if cancelled, false if the job is finished, or
+         * running job of submitRunner().
+         */
+        bool cancel(JobID id);
+
+        /**
+         * get number of jobs not started yet.
+         * @return number of jobs.
+         */
+        size_t pending();
+
+        /**
+         * wait until all jobs submitted end.
+         */
+        void wait();
+    private:
+        IntegrationScheduler(const IntegrationScheduler&);
+        IntegrationScheduler& operator=(const IntegrationScheduler&);
+        struct Job;
+        typedef std::shared_ptr<Job> JobPtr;
+        struct JobOrder {
+            bool operator()(const JobPtr& a, const JobPtr& b) const;
+        };
+        struct NetKey {
+            DigitalNetID id;
+            uint32_t s;
+            uint32_t m;
+            bool operator<(const NetKey& that) const;
+        };
+        typedef std::set<JobPtr, JobOrder> JobQueue;
+        typedef std::shared_ptr<std::atomic<bool> > StopFlag;
+        std::future<MCQMCResult> submitJob(const Runner& runner,
+                                           const IntegrationConfig& config,
+                                           JobID * id,
+                                           const StopFlag& stop);
+        void drain();
+        void remove(const JobPtr& job);
+        ThreadPool& pool;
+        size_t maxBatch;
+        std::mutex mtx;
+        std::condition_variable idleCond;
+        JobQueue queue;
+        std::map<NetKey, JobQueue> byNet;
+        std::map<JobID, JobPtr> byId;
+        std::map<JobID, JobPtr> runningById;
+        JobID nextId;
+        uint64_t sequence;
+        // jobs taken by workers and not finished
+        size_t running;
+        // tasks posted to pool and not finished
+        size_t outstanding;
+    };
+}
+#endif // MCQMC_INTEGRATION_INTEGRATION_SCHEDULER_H
@@ -19,7 +19,22 @@
  */
 
 #include <MCQMCIntegration/DigitalNet.h>
+#include <MCQMCIntegration/DigitalNetRegistry.h>
+#include <MCQMCIntegration/PointSetCache.h>
+#include <MCQMCIntegration/ThreadPool.h>
+#include <MCQMCIntegration/ProcessPool.h>
+#include <MCQMCIntegration/BatchIntegrand.h>
+#include <MCQMCIntegration/MersenneTwister64.h>
+#include <MCQMCIntegration/MTBlockRandom.h>
+#include <MCQMCIntegration/Checkpoint.h>
 #include <random>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <map>
 
 namespace MCQMCIntegration {
 
@@ -44,11 +59,102 @@ namespace MCQMCIntegration {
         double var() const;
         double absErr(const int prob) const;
         double relErr(const int prob) const;
+        int64_t getN() const {
+            return n;
+        }
+
+        /**
+         * add data of @b that, as if they were added to this.
+         *
+         * See "Parallel algorithm" at
+         * https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+         * @param[in] that other accumulator.
+         */
+        void merge(const OnlineVariance& that);
+
+        /**
+         * size of serialized state in bytes.
+         */
+        static const size_t serialized_size = 32;
+
+        /**
+         * write state in little endian, which can be read on other
+         * processes and hosts.
+         * @param[out] buffer serialized_size bytes.
+         */
+        void serialize(uint8_t buffer[]) const;
+
+        /**
+         * read state written by serialize().
+         * @param[in] buffer serialized state.
+         * @param[in] size size of @b buffer.
+         * @return false if @b buffer is not valid, state is not changed.
+         */
+        bool deserialize(const uint8_t buffer[], size_t size);
+    private:
+        int64_t n;
+        int64_t df;
+        double mean;
+        double M2;
+    };
+
+    /*
+     * calculate variance block by block.
+     *
+     * This is for inner loop of integration, where OnlineVariance
+     * divides at every data. Data are stored in a buffer, and a full
+     * block is summed in independent lanes, which can be vectorized,
+     * then merged into the statistics by parallel algorithm of Chan et
+     * al. See "Parallel algorithm" at
+     * https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+     */
+    class BlockVariance {
+    public:
+        BlockVariance();
+        void addData(const double x) {
+            buffer[used++] = x;
+            if (used == block_size) {
+                addBlock();
+            }
+        }
+        double getMean() const;
+        double unbiasedVar() const;
+        double var() const;
+        double absErr(const int prob) const;
+        double relErr(const int prob) const;
+        int64_t getN() const {
+            return n + used;
+        }
+
+        /**
+         * size of serialized state in bytes, which includes data in
+         * the buffer.
+         */
+        static const size_t serialized_size = 40 + 8 * 256;
+
+        /**
+         * write state in little endian, see OnlineVariance::serialize().
+         * @param[out] buffer serialized_size bytes.
+         */
+        void serialize(uint8_t buffer[]) const;
+
+        /**
+         * read state written by serialize().
+         * @param[in] buffer serialized state.
+         * @param[in] size size of @b buffer.
+         * @return false if @b buffer is not valid, state is not changed.
+         */
+        bool deserialize(const uint8_t buffer[], size_t size);
     private:
-        int n;
-        int df;
+        static const int block_size = 256;
+        static const int lanes = 8;
+        void addBlock();
+        void merged(int64_t * count, double * mean, double * M2) const;
+        int64_t n;
         double mean;
         double M2;
+        int used;
+        double buffer[block_size];
     };
 
     /**
@@ -60,6 +166,175 @@ namespace MCQMCIntegration {
         double error;
     };
 
+    /**
+     * Target and budget of adaptive integration.
+     *
+     * Integration stops when absolute error is not greater than
+     * @b absolute, or relative error is not greater than @b relative.
+     * Zero means the target is not used.
+     */
+    struct MCQMCTolerance {
+        MCQMCTolerance(double absolute = 0, double relative = 0,
+                       int probability = 99) {
+            this->absolute = absolute;
+            this->relative = relative;
+            this->probability = probability;
+            maxEvaluations = 0;
+            maxSeconds = 0;
+            minTrials = 8;
+            minM = 0;
+            maxM = 0;
+            seed = 1;
+        }
+        /** absolute error target */
+        double absolute;
+        /** relative error target */
+        double relative;
+        /** one of {95, 99, 999, 9999} */
+        int probability;
+        /** maximum number of integrand evaluations, 0 means no limit */
+        uint64_t maxEvaluations;
+        /** maximum time in seconds, 0 means no limit */
+        double maxSeconds;
+        /** number of randomizations at first */
+        uint32_t minTrials;
+        /** F2 dimension at first, 0 means the minimum of the net */
+        uint32_t minM;
+        /** maximum F2 dimension, 0 means the maximum of the net */
+        uint32_t maxM;
+        /** seed of digital shifts */
+        uint64_t seed;
+    };
+
+    /**
+     * Result of adaptive integration.
+     */
+    struct MCQMCAdaptiveResult {
+        double value;
+        double error;
+        /** number of randomizations used */
+        uint32_t N;
+        /** F2 dimension used */
+        uint32_t m;
+        /** number of integrand evaluations */
+        uint64_t evaluations;
+        /** true if the target is met */
+        bool converged;
+    };
+
+    /**
+     * Progress of integration, reported to ProgressObserver.
+     */
+    struct MCQMCProgress {
+        /** current estimate */
+        double value;
+        /** absolute error of the estimate, NaN if not available */
+        double error;
+        /** number of randomizations done */
+        uint32_t trials;
+        /** number of integrand evaluations */
+        uint64_t points;
+        /** seconds from start */
+        double seconds;
+        /** integrand evaluations per second */
+        double throughput;
+    };
+
+    /**
+     * Observer of integration progress.
+     *
+     * @b callback is called every @b intervalPoints points, or at the
+     * end of each randomization if @b intervalPoints is 0. When it
+     * returns false, integration stops and returns the estimate of
+     * the progress.
+     */
+    struct ProgressObserver {
+        typedef std::function<bool(const MCQMCProgress& progress)> Callback;
+        ProgressObserver(const Callback& callback = Callback(),
+                         uint64_t intervalPoints = 0) {
+            this->callback = callback;
+            this->intervalPoints = intervalPoints;
+        }
+        /** called with progress, returns false to stop */
+        Callback callback;
+        /** interval in number of points, 0 means each randomization */
+        uint64_t intervalPoints;
+    };
+
+    /*
+     * counts points and reports progress to ProgressObserver.
+     *
+     * Estimate is the mean of randomizations done, or the mean of
+     * points of current randomization before the first randomization
+     * is done, whose error is that of Monte-Carlo method.
+     */
+    class ProgressTracker {
+    public:
+        ProgressTracker(const ProgressObserver& observer, int probability);
+
+        /**
+         * count a point.
+         * @return true if report() should be called.
+         */
+        bool due() {
+            return ++points >= nextReport;
+        }
+
+        /**
+         * report progress to observer.
+         * @param[in] eachintval statistics of randomizations done.
+         * @param[in] intsum statistics of current randomization.
+         * @return false if observer requests to stop.
+         */
+        bool report(const OnlineVariance& eachintval,
+                    const BlockVariance& intsum);
+
+        /**
+         * result at the last report.
+         * @return estimate and error.
+         */
+        MCQMCResult partial() const {
+            return MCQMCResult({progress.value, progress.error});
+        }
+    private:
+        ProgressObserver observer;
+        int probability;
+        uint64_t points;
+        uint64_t nextReport;
+        std::chrono::steady_clock::time_point start;
+        MCQMCProgress progress;
+    };
+
+    /*
+     * mean of integrand at @b m random points, of a trial of Monte-Carlo
+     * integration.
+     *
+     * @param[in,out] feeder feeder of integrand.
+     * @param[in,out] rand random number generator.
+     * @param[in,out] dist random number distribution class.
+     * @param[in] m sample number per a trial.
+     * @param[in,out] point work area of s elements.
+     * @return mean.
+     */
+    template<typename I, typename R, typename D>
+        double mc_trial_mean(BatchFeeder<I>& feeder,
+                             R& rand,
+                             D& dist,
+                             uint32_t m,
+                             std::vector<double>& point)
+    {
+        size_t s = point.size();
+        BlockVariance intsum;
+        for (uint32_t j = 0; j < m; ++j) {
+            for (size_t i = 0; i < s; ++i) {
+                point[i] = dist(rand);
+            }
+            feeder.add(&point[0], intsum);
+        }
+        feeder.flush(intsum);
+        return intsum.getMean();
+    }
+
     /*
      * Monte-Carlo Integration.
      *
@@ -71,7 +346,7 @@ namespace MCQMCIntegration {
      * @param[in] m sample number per a trial.
      * @param[in] N number of trials.
      * @param[in,out] integrand integrand function class, which should have
-     * double operator()(double[]).
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
      * @param[in,out] rand random number generator.
      * @param[in,out] dist random number distribution class.
      * @param[in] probability expected probability of returned value x is
@@ -88,17 +363,61 @@ namespace MCQMCIntegration {
                                             D& dist,
                                             int probability = 99)
     {
-        double point[s];
+        std::vector<double> point(s);
+        BatchFeeder<I> feeder(integrand, s);
         OnlineVariance eachintval;
         uint32_t cnt = 0;
         do {
-            OnlineVariance intsum;
-            for (uint32_t j = 0; j < m; ++j) {
-                for (uint32_t i = 0; i < s; ++i) {
-                    point[i] = dist(rand);
+            eachintval.addData(mc_trial_mean(feeder, rand, dist, m, point));
+            ++cnt;
+        } while ( cnt < N );
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+
+    /*
+     * Monte-Carlo Integration with block random number generator.
+     *
+     * Coordinates of uniform random points are generated by
+     * MTBlockRandom::fill() for s times B points at once, where B points
+     * fit in cache.
+     *
+     * @tperm I integrand function class.
+     *
+     * @param[in] s dimension of integration area @b R.
+     * @param[in] m sample number per a trial.
+     * @param[in] N number of trials.
+     * @param[in,out] integrand integrand function class, which should have
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
+     * @param[in,out] rand block random number generator.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return MCQMCResult.
+     */
+    template<typename I>
+        MCQMCResult monte_carlo_integration(uint32_t s,
+                                            uint32_t m,
+                                            uint32_t N,
+                                            I& integrand,
+                                            MTBlockRandom& rand,
+                                            int probability = 99)
+    {
+        size_t block = batch_chunk_size(s);
+        std::vector<double> points(block * s);
+        BatchFeeder<I> feeder(integrand, s);
+        OnlineVariance eachintval;
+        uint32_t cnt = 0;
+        do {
+            BlockVariance intsum;
+            for (uint32_t j = 0; j < m; j += block) {
+                size_t n = std::min(static_cast<size_t>(m - j), block);
+                rand.fill(&points[0], n * s);
+                for (size_t i = 0; i < n; i++) {
+                    feeder.add(&points[i * s], intsum);
                 }
-                intsum.addData(integrand(point));
             }
+            feeder.flush(intsum);
             eachintval.addData(intsum.getMean());
             ++cnt;
         } while ( cnt < N );
@@ -106,6 +425,95 @@ namespace MCQMCIntegration {
                     eachintval.absErr(probability)});
     }
 
+    /*
+     * Monte-Carlo Integration on thread pool.
+     *
+     * Trials are divided into contiguous ranges, one for each worker.
+     * The generator of a worker starts where the serial version would
+     * be at the first trial of its range, by jump ahead of
+     * MersenneTwister64, so the result is the same as
+     * monte_carlo_integration() with std::mt19937_64 of the same state,
+     * and does not depend on number of threads.
+     *
+     * @tperm F integrand factory, F() returns an integrand function class
+     * object. It is called size of pool times on the calling thread.
+     * @tparm D Distribution class, which should use just one output of
+     * generator per a call, as std::uniform_real_distribution<double>.
+     * It is copied for each range.
+     *
+     * @param[in] s dimension of integration area @b R.
+     * @param[in] m sample number per a trial.
+     * @param[in] N number of trials.
+     * @param[in] factory integrand factory, for example
+     * [&]() { return integrand; } to clone @b integrand.
+     * @param[in,out] rand random number generator, which is advanced as
+     * monte_carlo_integration() does.
+     * @param[in] dist random number distribution class.
+     * @param[in,out] pool thread pool.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return MCQMCResult.
+     */
+    template<typename F, typename D>
+        MCQMCResult parallel_monte_carlo_integration(uint32_t s,
+                                                     uint32_t m,
+                                                     uint32_t N,
+                                                     F factory,
+                                                     MersenneTwister64& rand,
+                                                     const D& dist,
+                                                     ThreadPool& pool,
+                                                     int probability = 99)
+    {
+        typedef decltype(factory()) I;
+        uint32_t count = N == 0 ? 1 : N;
+        uint64_t draws = static_cast<uint64_t>(m) * s;
+        uint32_t ranges = std::min(count, static_cast<uint32_t>(pool.size()));
+        // jump polynomials are shared by ranges of the same length
+        std::map<uint64_t, std::unique_ptr<MTJumpPolynomial> > jumps;
+        auto jump = [&](MersenneTwister64& mt, uint64_t trials) {
+            uint64_t steps = trials * draws;
+            std::unique_ptr<MTJumpPolynomial>& poly = jumps[steps];
+            if (!poly) {
+                poly.reset(new MTJumpPolynomial(steps));
+            }
+            poly->apply(mt);
+        };
+        std::vector<uint32_t> first(ranges + 1);
+        std::vector<MersenneTwister64> generators;
+        for (uint32_t w = 0; w <= ranges; w++) {
+            first[w] = static_cast<uint32_t>(
+                static_cast<uint64_t>(count) * w / ranges);
+        }
+        generators.push_back(rand);
+        for (uint32_t w = 1; w < ranges; w++) {
+            generators.push_back(generators[w - 1]);
+            jump(generators[w], first[w] - first[w - 1]);
+        }
+        std::vector<std::unique_ptr<I> > integrands(pool.size());
+        for (unsigned w = 0; w < pool.size(); w++) {
+            integrands[w].reset(new I(factory()));
+        }
+        std::vector<double> means(count);
+        pool.run(ranges, [&](unsigned worker, size_t w) {
+                BatchFeeder<I> feeder(*integrands[worker], s);
+                MersenneTwister64& mt = generators[w];
+                D d(dist);
+                std::vector<double> point(s);
+                for (uint32_t t = first[w]; t < first[w + 1]; t++) {
+                    means[t] = mc_trial_mean(feeder, mt, d, m, point);
+                }
+            });
+        // generators[ranges - 1] is at the end
+        rand = generators[ranges - 1];
+        OnlineVariance eachintval;
+        for (uint32_t t = 0; t < count; t++) {
+            eachintval.addData(means[t]);
+        }
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+
     /*
      * Quasi Monte-Carlo Integration
      *
@@ -114,7 +522,7 @@ namespace MCQMCIntegration {
      *
      * @param[in] N number of trials.
      * @param[in,out] integrand integrand function class, which should have
-     * double operator()(double[]).
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
      * @param[in,out] digitalNet digital net class.
      * @param[in] probability expected probability of returned value x is
      * between x - absolute error and x + absolute error. this should be
@@ -130,16 +538,18 @@ namespace MCQMCIntegration {
         uint32_t m = digitalNet.getM();
         digitalNet.setDigitalShift(true);
         digitalNet.pointInitialize();
+        BatchFeeder<I> feeder(integrand, digitalNet.getS());
         OnlineVariance eachintval;
         uint32_t cnt = 0;
         do {
-            OnlineVariance intsum;
+            BlockVariance intsum;
             uint64_t max = 1;
             max = max << m;
             for (uint64_t j = 0; j < max; ++j) {
-                intsum.addData(integrand(digitalNet.getPoint()));
+                feeder.add(digitalNet.getPoint(), intsum);
                 digitalNet.nextPoint();
             }
+            feeder.flush(intsum);
             eachintval.addData(intsum.getMean());
             digitalNet.pointInitialize();
             cnt++;
@@ -148,6 +558,254 @@ namespace MCQMCIntegration {
                     eachintval.absErr(probability)});
     }
 
+    /*
+     * Quasi Monte-Carlo Integration with progress reports.
+     *
+     * The result is the same as quasi_monte_carlo_integration() without
+     * observer, unless the observer stops the integration.
+     *
+     * @tperm I integrand function class
+     * @tparm D DigitalNet class for Quasi Monete-Carlo integration.
+     *
+     * @param[in] N number of trials.
+     * @param[in,out] integrand integrand function class, which should have
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
+     * @param[in,out] digitalNet digital net class.
+     * @param[in] observer callback and interval of reports.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return MCQMCResult, which is the estimate of the last report if
+     * stopped by observer.
+     */
+    template<typename I, typename D>
+        MCQMCResult quasi_monte_carlo_integration(uint32_t N,
+                                                  I& integrand,
+                                                  D& digitalNet,
+                                                  const ProgressObserver&
+                                                  observer,
+                                                  int probability = 99)
+    {
+        uint32_t m = digitalNet.getM();
+        uint64_t max = UINT64_C(1) << m;
+        digitalNet.setDigitalShift(true);
+        digitalNet.pointInitialize();
+        BatchFeeder<I> feeder(integrand, digitalNet.getS());
+        ProgressTracker tracker(observer, probability);
+        OnlineVariance eachintval;
+        uint32_t cnt = 0;
+        do {
+            BlockVariance intsum;
+            for (uint64_t j = 0; j < max; ++j) {
+                feeder.add(digitalNet.getPoint(), intsum);
+                digitalNet.nextPoint();
+                if (tracker.due()) {
+                    feeder.flush(intsum);
+                    if (!tracker.report(eachintval, intsum)) {
+                        return tracker.partial();
+                    }
+                }
+            }
+            feeder.flush(intsum);
+            eachintval.addData(intsum.getMean());
+            digitalNet.pointInitialize();
+            cnt++;
+            if (observer.intervalPoints == 0 && cnt < N
+                && !tracker.report(eachintval, BlockVariance())) {
+                return tracker.partial();
+            }
+        } while ( cnt < N );
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+
+    /*
+     * Quasi Monte-Carlo Integration of vector valued integrand.
+     *
+     * K functions are integrated over the same points, which are
+     * generated once. Result of k th value is the same as
+     * quasi_monte_carlo_integration() of k th function.
+     *
+     * @tperm I vector valued integrand function class, see
+     * BatchIntegrand.h.
+     * @tparm D DigitalNet class for Quasi Monete-Carlo integration.
+     *
+     * @param[in] N number of trials.
+     * @param[in] K number of values of integrand.
+     * @param[in,out] integrand integrand function class, which should have
+     * void operator()(const double[], double[]) or batch operator() of
+     * vector valued integrand.
+     * @param[in,out] digitalNet digital net class.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return K MCQMCResults.
+     */
+    template<typename I, typename D>
+        std::vector<MCQMCResult> vector_quasi_monte_carlo_integration(
+            uint32_t N,
+            size_t K,
+            I& integrand,
+            D& digitalNet,
+            int probability = 99)
+    {
+        uint32_t m = digitalNet.getM();
+        digitalNet.setDigitalShift(true);
+        digitalNet.pointInitialize();
+        VectorFeeder<I> feeder(integrand, digitalNet.getS(), K);
+        std::vector<OnlineVariance> eachintval(K);
+        uint32_t cnt = 0;
+        do {
+            std::vector<BlockVariance> intsum(K);
+            uint64_t max = 1;
+            max = max << m;
+            for (uint64_t j = 0; j < max; ++j) {
+                feeder.add(digitalNet.getPoint(), intsum);
+                digitalNet.nextPoint();
+            }
+            feeder.flush(intsum);
+            for (size_t k = 0; k < K; k++) {
+                eachintval[k].addData(intsum[k].getMean());
+            }
+            digitalNet.pointInitialize();
+            cnt++;
+        } while ( cnt < N );
+        std::vector<MCQMCResult> result(K);
+        for (size_t k = 0; k < K; k++) {
+            result[k].value = eachintval[k].getMean();
+            result[k].error = eachintval[k].absErr(probability);
+        }
+        return result;
+    }
+
+    /*
+     * Quasi Monte-Carlo Integration using cache of point sets.
+     *
+     * Point set of each randomization is taken from @b cache, or made
+     * and stored there. The result is the same as without cache, if
+     * the format is POINT_DOUBLE.
+     *
+     * @tperm I integrand function class
+     *
+     * @param[in] N number of trials.
+     * @param[in,out] integrand integrand function class, which should have
+     * double operator()(const double[]) or batch operator() of
+     * BatchIntegrand.h.
+     * @param[in,out] digitalNet digital net class.
+     * @param[in,out] cache cache of point sets.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @param[in] format element type of cached points.
+     * @return MCQMCResult.
+     */
+    template<typename I>
+        MCQMCResult quasi_monte_carlo_integration(uint32_t N,
+                                                  I& integrand,
+                                                  DigitalNet<uint64_t>&
+                                                  digitalNet,
+                                                  PointSetCache& cache,
+                                                  int probability = 99,
+                                                  PointFormat format
+                                                  = POINT_DOUBLE)
+    {
+        digitalNet.setDigitalShift(true);
+        digitalNet.pointInitialize();
+        std::vector<double> point(digitalNet.getS());
+        BatchFeeder<I> feeder(integrand, digitalNet.getS());
+        OnlineVariance eachintval;
+        uint32_t cnt = 0;
+        do {
+            std::shared_ptr<const MappedPointSet> set
+                = cache.get(digitalNet, format);
+            BlockVariance intsum;
+            uint64_t max = set->size();
+            for (uint64_t j = 0; j < max; ++j) {
+                const double * p = set->getPoint(j);
+                if (p == NULL) {
+                    set->getPoint(j, &point[0]);
+                    p = &point[0];
+                }
+                feeder.add(p, intsum);
+            }
+            feeder.flush(intsum);
+            eachintval.addData(intsum.getMean());
+            // consume random numbers as nextPoint() does at the end of
+            // point set, then go to next randomization.
+            digitalNet.pointInitialize();
+            digitalNet.pointInitialize();
+            cnt++;
+        } while ( cnt < N );
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+
+    /*
+     * Quasi Monte-Carlo Integration with checkpoints.
+     *
+     * State of integration is written to checkpoint file at intervals
+     * of @b checkpoint. If the file of the same integration exists at
+     * start, the integration resumes from it, and the result is the
+     * same as the integration which is not interrupted. Otherwise the
+     * result is the same as quasi_monte_carlo_integration() without
+     * checkpoint.
+     *
+     * @tperm I integrand function class
+     *
+     * @param[in] N number of trials.
+     * @param[in,out] integrand integrand function class, which should have
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
+     * @param[in,out] digitalNet digital net class.
+     * @param[in] checkpoint checkpoint file and intervals.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return MCQMCResult.
+     * @throw runtime_error when can't write checkpoint file.
+     */
+    template<typename I>
+        MCQMCResult quasi_monte_carlo_integration(uint32_t N,
+                                                  I& integrand,
+                                                  DigitalNet<uint64_t>&
+                                                  digitalNet,
+                                                  const CheckpointConfig&
+                                                  checkpoint,
+                                                  int probability = 99)
+    {
+        uint32_t m = digitalNet.getM();
+        uint64_t max = UINT64_C(1) << m;
+        Checkpoint state(checkpoint, N);
+        BatchFeeder<I> feeder(integrand, digitalNet.getS());
+        OnlineVariance eachintval;
+        BlockVariance intsum;
+        uint32_t cnt = 0;
+        uint64_t j = 0;
+        if (!state.restore(digitalNet, &cnt, &j, eachintval, intsum)) {
+            digitalNet.setDigitalShift(true);
+            digitalNet.pointInitialize();
+        }
+        do {
+            for (; j < max; ++j) {
+                feeder.add(digitalNet.getPoint(), intsum);
+                digitalNet.nextPoint();
+                if (state.due()) {
+                    // values of points done should be in intsum
+                    feeder.flush(intsum);
+                    state.save(digitalNet, cnt, j + 1, eachintval, intsum);
+                }
+            }
+            feeder.flush(intsum);
+            eachintval.addData(intsum.getMean());
+            intsum = BlockVariance();
+            digitalNet.pointInitialize();
+            cnt++;
+            j = 0;
+        } while ( cnt < N );
+        state.finish();
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+
     /*
      * Quasi Monte-Carlo Integration
      *
@@ -155,12 +813,14 @@ namespace MCQMCIntegration {
      *
      * @param[in] N number of trials.
      * @param[in,out] integrand integrand function class, which should have
-     * double operator()(double[]).
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
      * @param[in,out] digitalNet digital net class.
      * @param[in] probability expected probability of returned value x is
      * between x - absolute error and x + absolute error. this should be
      * one of {95, 99, 999, 9999}.
      * @return MCQMCResult.
+     * @note Digital net is kept in DigitalNetRegistry, and following
+     * calls of the same digitalNetId, s and m do not read data again.
      */
     template<typename I>
         MCQMCResult quasi_monte_carlo_integration(uint32_t N,
@@ -170,19 +830,23 @@ namespace MCQMCIntegration {
                                                   uint32_t m,
                                                   int probability)
     {
-        DigitalNet<uint64_t> digitalNet(digitalNetId, s, m);
+        // base matrix is shared through process-wide registry
+        DigitalNet<uint64_t> digitalNet(
+            DigitalNetRegistry::getInstance().get(digitalNetId, s, m));
         digitalNet.setDigitalShift(true);
         digitalNet.pointInitialize();
+        BatchFeeder<I> feeder(integrand, digitalNet.getS());
         OnlineVariance eachintval;
         uint32_t cnt = 0;
         do {
-            OnlineVariance intsum;
+            BlockVariance intsum;
             uint64_t max = 1;
             max = max << m;
             for (uint64_t j = 0; j < max; ++j) {
-                intsum.addData(integrand(digitalNet.getPoint()));
+                feeder.add(digitalNet.getPoint(), intsum);
                 digitalNet.nextPoint();
             }
+            feeder.flush(intsum);
             eachintval.addData(intsum.getMean());
             digitalNet.pointInitialize();
             cnt++;
@@ -190,5 +854,539 @@ namespace MCQMCIntegration {
         return MCQMCResult({eachintval.getMean(),
                     eachintval.absErr(probability)});
     }
+
+    /*
+     * integrate over a randomization, the point set of @b cursor shifted
+     * by @b shift.
+     *
+     * @param[in,out] integrand integrand function class.
+     * @param[in,out] cursor digital net, its point is re-initialized.
+     * @param[in] shift digital shift of @b s elements.
+     * @return mean of integrand over the point set.
+     */
+    template<typename I>
+        double qmc_randomization_mean(I& integrand,
+                                      DigitalNet<uint64_t>& cursor,
+                                      const uint64_t shift[])
+    {
+        cursor.setDigitalShift(false);
+        cursor.pointInitialize();
+        cursor.setShift(shift);
+        BatchFeeder<I> feeder(integrand, cursor.getS());
+        BlockVariance intsum;
+        uint64_t max = 1;
+        max = max << cursor.getM();
+        for (uint64_t j = 0; j < max; ++j) {
+            feeder.add(cursor.getPoint(), intsum);
+            cursor.nextPoint();
+        }
+        feeder.flush(intsum);
+        return intsum.getMean();
+    }
+
+    /*
+     * draw digital shifts of @b count randomizations in the same order as
+     * quasi_monte_carlo_integration().
+     *
+     * @param[in,out] digitalNet digital net class.
+     * @param[in] count number of randomizations.
+     * @param[out] shifts shift of randomization r is shifts[r * s] ..
+     * shifts[r * s + s - 1].
+     */
+    inline void qmc_draw_shifts(DigitalNet<uint64_t>& digitalNet,
+                                uint32_t count,
+                                std::vector<uint64_t>& shifts)
+    {
+        uint32_t s = digitalNet.getS();
+        digitalNet.requireDimension(s);
+        digitalNet.setDigitalShift(true);
+        digitalNet.pointInitialize();
+        shifts.resize(static_cast<size_t>(count) * s);
+        for (uint32_t r = 0; r < count; r++) {
+            const uint64_t * shift = digitalNet.getShift();
+            std::copy(shift, shift + s, shifts.begin() + r * s);
+            // the serial version draws shifts twice per trial
+            digitalNet.pointInitialize();
+            digitalNet.pointInitialize();
+        }
+    }
+
+    /*
+     * Quasi Monte-Carlo Integration on thread pool.
+     *
+     * Randomizations are spread over worker threads of @b pool. Each
+     * worker has its own integrand made by @b factory and its own cursor
+     * sharing base matrix of @b digitalNet. Digital shifts are drawn from
+     * @b digitalNet in the same order as quasi_monte_carlo_integration(),
+     * and means of randomizations are combined in order of
+     * randomization, so the result is the same as the serial one.
+     *
+     * @tperm F integrand factory, F() returns an integrand function class
+     * object. It is called size of pool times on the calling thread.
+     *
+     * @param[in] N number of trials.
+     * @param[in] factory integrand factory, for example
+     * [&]() { return integrand; } to clone @b integrand.
+     * @param[in,out] digitalNet digital net class.
+     * @param[in,out] pool thread pool.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return MCQMCResult.
+     */
+    template<typename F>
+        MCQMCResult parallel_quasi_monte_carlo_integration(
+            uint32_t N,
+            F factory,
+            DigitalNet<uint64_t>& digitalNet,
+            ThreadPool& pool,
+            int probability = 99)
+    {
+        typedef decltype(factory()) I;
+        uint32_t s = digitalNet.getS();
+        // at least one trial, as the serial version
+        uint32_t count = N == 0 ? 1 : N;
+        std::vector<uint64_t> shifts;
+        qmc_draw_shifts(digitalNet, count, shifts);
+        std::shared_ptr<const DigitalNet<uint64_t> >
+            prototype(&digitalNet, [](const DigitalNet<uint64_t> *) {});
+        std::vector<std::unique_ptr<DigitalNet<uint64_t> > >
+            cursors(pool.size());
+        std::vector<std::unique_ptr<I> > integrands(pool.size());
+        for (unsigned w = 0; w < pool.size(); w++) {
+            cursors[w].reset(new DigitalNet<uint64_t>(prototype));
+            integrands[w].reset(new I(factory()));
+        }
+        std::vector<double> means(count);
+        pool.run(count, [&](unsigned worker, size_t r) {
+                means[r] = qmc_randomization_mean(*integrands[worker],
+                                                  *cursors[worker],
+                                                  &shifts[r * s]);
+            });
+        OnlineVariance eachintval;
+        for (uint32_t r = 0; r < count; r++) {
+            eachintval.addData(means[r]);
+        }
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+
+    /*
+     * plain sum, accumulator for BatchFeeder.
+     */
+    class BlockSum {
+    public:
+        BlockSum() {
+            sum = 0;
+        }
+        void addData(const double x) {
+            sum += x;
+        }
+        double getSum() const {
+            return sum;
+        }
+    private:
+        double sum;
+    };
+
+    /*
+     * Quasi Monte-Carlo Integration on thread pool, each randomization
+     * is split over worker threads.
+     *
+     * This is for few randomizations of a large point set, where
+     * parallel_quasi_monte_carlo_integration() can't use all workers.
+     * Points of a randomization are divided into blocks of consecutive
+     * indexes, and blocks are distributed by StealingScheduler, so
+     * workers which finish early take blocks of others. A worker starts
+     * a chunk of blocks with DigitalNet::setIndex() and follows with
+     * nextPoint(). Sums of blocks are added in order of block, so the
+     * result does not depend on number of threads nor on scheduling,
+     * but may differ from quasi_monte_carlo_integration() by rounding
+     * error.
+     *
+     * @tperm F integrand factory, F() returns an integrand function class
+     * object. It is called size of pool times on the calling thread.
+     *
+     * @param[in] N number of trials.
+     * @param[in] factory integrand factory, for example
+     * [&]() { return integrand; } to clone @b integrand.
+     * @param[in,out] digitalNet digital net class.
+     * @param[in,out] pool thread pool.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @return MCQMCResult.
+     */
+    template<typename F>
+        MCQMCResult stealing_quasi_monte_carlo_integration(
+            uint32_t N,
+            F factory,
+            DigitalNet<uint64_t>& digitalNet,
+            ThreadPool& pool,
+            int probability = 99)
+    {
+        typedef decltype(factory()) I;
+        uint32_t s = digitalNet.getS();
+        uint32_t m = digitalNet.getM();
+        uint32_t count = N == 0 ? 1 : N;
+        std::vector<uint64_t> shifts;
+        qmc_draw_shifts(digitalNet, count, shifts);
+        std::shared_ptr<const DigitalNet<uint64_t> >
+            prototype(&digitalNet, [](const DigitalNet<uint64_t> *) {});
+        std::vector<std::unique_ptr<DigitalNet<uint64_t> > >
+            cursors(pool.size());
+        std::vector<std::unique_ptr<I> > integrands(pool.size());
+        std::vector<std::unique_ptr<BatchFeeder<I> > > feeders(pool.size());
+        for (unsigned w = 0; w < pool.size(); w++) {
+            cursors[w].reset(new DigitalNet<uint64_t>(prototype));
+            integrands[w].reset(new I(factory()));
+            feeders[w].reset(new BatchFeeder<I>(*integrands[w], s));
+        }
+        // block size is fixed, so that the sum does not depend on
+        // scheduling
+        uint64_t size = UINT64_C(1) << m;
+        uint64_t blockSize = std::min(size, UINT64_C(1) << 10);
+        size_t blocks = static_cast<size_t>(size / blockSize);
+        std::vector<double> sums(blocks);
+        OnlineVariance eachintval;
+        for (uint32_t r = 0; r < count; r++) {
+            const uint64_t * shift = &shifts[r * s];
+            StealingScheduler scheduler(blocks, pool.size());
+            pool.run(pool.size(), [&](unsigned worker, size_t slot) {
+                    BatchFeeder<I>& feeder = *feeders[worker];
+                    DigitalNet<uint64_t>& cursor = *cursors[worker];
+                    cursor.setDigitalShift(false);
+                    cursor.pointInitialize();
+                    cursor.setShift(shift);
+                    size_t first;
+                    size_t last;
+                    unsigned id = static_cast<unsigned>(slot);
+                    while (scheduler.next(id, &first, &last)) {
+                        std::chrono::steady_clock::time_point start
+                            = std::chrono::steady_clock::now();
+                        cursor.setIndex(first * blockSize);
+                        for (size_t b = first; b < last; b++) {
+                            if (b != first) {
+                                cursor.nextPoint();
+                            }
+                            BlockSum sum;
+                            for (uint64_t j = 0; j < blockSize; j++) {
+                                if (j != 0) {
+                                    cursor.nextPoint();
+                                }
+                                feeder.add(cursor.getPoint(), sum);
+                            }
+                            feeder.flush(sum);
+                            sums[b] = sum.getSum();
+                        }
+                        std::chrono::duration<double> elapsed
+                            = std::chrono::steady_clock::now() - start;
+                        scheduler.report(id, last - first, elapsed.count());
+                    }
+                });
+            double sum = 0;
+            for (size_t b = 0; b < blocks; b++) {
+                sum += sums[b];
+            }
+            eachintval.addData(sum / static_cast<double>(size));
+        }
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
+
+    /*
+     * add values of points @b first .. @b last - 1 of a randomization.
+     *
+     * @param[in,out] feeder feeder of integrand.
+     * @param[in,out] cursor digital net, its point is re-initialized.
+     * @param[in] shift digital shift of @b s elements.
+     * @param[in] first first index of points.
+     * @param[in] last end of indexes of points, not greater than
+     * 2<sup>m</sup>.
+     * @return sum of values.
+     */
+    template<typename I>
+        double qmc_partial_sum(BatchFeeder<I>& feeder,
+                               DigitalNet<uint64_t>& cursor,
+                               const uint64_t shift[],
+                               uint64_t first,
+                               uint64_t last)
+    {
+        cursor.setDigitalShift(false);
+        cursor.pointInitialize();
+        cursor.setShift(shift);
+        if (first != 0) {
+            cursor.setIndex(first);
+        }
+        BlockSum sum;
+        for (uint64_t j = first; j < last; j++) {
+            if (j != first) {
+                cursor.nextPoint();
+            }
+            feeder.add(cursor.getPoint(), sum);
+        }
+        feeder.flush(sum);
+        return sum.getSum();
+    }
+
+    /*
+     * check first 2<sup>m</sup> points of @b small and @b large are the
+     * same, where m is F2 dimension of @b small.
+     */
+    inline bool qmc_same_prefix(const DigitalNet<uint64_t>& small,
+                                const DigitalNet<uint64_t>& large)
+    {
+        // point of index < 2^m uses only first m rows of base
+        for (uint32_t k = 0; k < small.getM(); k++) {
+            for (uint32_t j = 0; j < small.getS(); j++) {
+                if (small.getBase(k, j) != large.getBase(k, j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Adaptive Quasi Monte-Carlo Integration.
+     *
+     * Starts with tolerance.minTrials randomizations of 2<sup>minM</sup>
+     * points, and grows until the error target of @b tolerance is met or
+     * the budget is exhausted. The first evaluation is in the budget,
+     * randomizations at first are reduced to fit in maxEvaluations.
+     * m is increased first, because error of QMC decreases faster by
+     * points than by randomizations, then the number of randomizations
+     * is doubled when m reaches maxM. When m is increased and the first
+     * rows of base matrix are the same, as Sobol sequence, the values of
+     * the first 2<sup>m</sup> points are reused and only the new points
+     * are evaluated.
+     *
+     * @tperm I integrand function class
+     *
+     * @param[in,out] integrand integrand function class, which should have
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
+     * @param[in] digitalNetId ID of pre-defined digital net.
+     * @param[in] s dimension of integration.
+     * @param[in] tolerance target and budget.
+     * @return MCQMCAdaptiveResult, converged is false if the budget is
+     * exhausted before the target is met.
+     * @throw runtime_error when neither target nor budget is given, or
+     * maxEvaluations is less than two randomizations of 2<sup>minM</sup>
+     * points.
+     */
+    template<typename I>
+        MCQMCAdaptiveResult adaptive_quasi_monte_carlo_integration(
+            I& integrand,
+            DigitalNetID digitalNetId,
+            uint32_t s,
+            const MCQMCTolerance& tolerance)
+    {
+        if (tolerance.absolute <= 0 && tolerance.relative <= 0
+            && tolerance.maxEvaluations == 0 && tolerance.maxSeconds <= 0) {
+            //throw runtime_error("no tolerance nor budget!");
+            throw "no tolerance nor budget!";
+        }
+        std::chrono::steady_clock::time_point start
+            = std::chrono::steady_clock::now();
+        uint32_t m = tolerance.minM;
+        if (m == 0 || m < getMMin(digitalNetId, s)) {
+            m = getMMin(digitalNetId, s);
+        }
+        uint32_t maxM = getMMax(digitalNetId, s);
+        if (tolerance.maxM != 0 && tolerance.maxM < maxM) {
+            maxM = std::max(tolerance.maxM, m);
+        }
+        uint32_t N = std::max(tolerance.minTrials, UINT32_C(2));
+        if (tolerance.maxEvaluations > 0) {
+            // the first evaluation is also in the budget
+            uint64_t trials = tolerance.maxEvaluations >> m;
+            if (trials < 2) {
+                //throw runtime_error("budget is less than the first evaluation!");
+                throw "budget is less than the first evaluation!";
+            }
+            if (trials < N) {
+                N = static_cast<uint32_t>(trials);
+            }
+        }
+        BatchFeeder<I> feeder(integrand, s);
+        std::mt19937_64 mt(tolerance.seed);
+        SharedDigitalNet net
+            = DigitalNetRegistry::getInstance().get(digitalNetId, s, m);
+        std::unique_ptr<DigitalNet<uint64_t> >
+            cursor(new DigitalNet<uint64_t>(net));
+        std::vector<uint64_t> shifts;
+        // sums[r] is sum of first 2^m points of randomization r
+        std::vector<double> sums;
+        uint64_t evaluations = 0;
+        MCQMCAdaptiveResult result;
+        uint32_t done = 0;
+        for (;;) {
+            // evaluate randomizations done .. N - 1 of 2^m points
+            shifts.resize(static_cast<size_t>(N) * s);
+            sums.resize(N);
+            for (uint32_t r = done; r < N; r++) {
+                for (uint32_t j = 0; j < s; j++) {
+                    shifts[r * s + j] = mt();
+                }
+                sums[r] = qmc_partial_sum(feeder, *cursor, &shifts[r * s],
+                                          0, UINT64_C(1) << m);
+                evaluations += UINT64_C(1) << m;
+            }
+            done = N;
+            OnlineVariance eachintval;
+            for (uint32_t r = 0; r < N; r++) {
+                eachintval.addData(sums[r] / std::ldexp(1.0, m));
+            }
+            result.value = eachintval.getMean();
+            result.error = eachintval.absErr(tolerance.probability);
+            result.N = N;
+            result.m = m;
+            result.evaluations = evaluations;
+            result.converged
+                = (tolerance.absolute > 0
+                   && result.error <= tolerance.absolute)
+                || (tolerance.relative > 0
+                    && result.error <= tolerance.relative
+                    * std::fabs(result.value));
+            if (result.converged) {
+                return result;
+            }
+            std::chrono::duration<double> elapsed
+                = std::chrono::steady_clock::now() - start;
+            if (tolerance.maxSeconds > 0
+                && elapsed.count() >= tolerance.maxSeconds) {
+                return result;
+            }
+            if (m < maxM) {
+                SharedDigitalNet next = DigitalNetRegistry::getInstance()
+                    .get(digitalNetId, s, m + 1);
+                bool reuse = qmc_same_prefix(*net, *next);
+                uint64_t cost = static_cast<uint64_t>(N) << m;
+                if (!reuse) {
+                    cost *= 2;
+                }
+                if (tolerance.maxEvaluations > 0
+                    && evaluations + cost > tolerance.maxEvaluations) {
+                    return result;
+                }
+                net = next;
+                cursor.reset(new DigitalNet<uint64_t>(net));
+                for (uint32_t r = 0; r < N; r++) {
+                    if (reuse) {
+                        sums[r] += qmc_partial_sum(feeder, *cursor,
+                                                   &shifts[r * s],
+                                                   UINT64_C(1) << m,
+                                                   UINT64_C(1) << (m + 1));
+                    } else {
+                        sums[r] = qmc_partial_sum(feeder, *cursor,
+                                                  &shifts[r * s],
+                                                  0, UINT64_C(1) << (m + 1));
+                    }
+                }
+                evaluations += cost;
+                m++;
+            } else {
+                uint64_t cost = static_cast<uint64_t>(N) << m;
+                if (N > UINT32_MAX / 2
+                    || (tolerance.maxEvaluations > 0
+                        && evaluations + cost > tolerance.maxEvaluations)) {
+                    return result;
+                }
+                N *= 2;
+            }
+        }
+    }
+
+    /*
+     * Quasi Monte-Carlo Integration on worker processes.
+     *
+     * This is for integrands which are not thread safe. Worker processes
+     * of @b pool are copies of the calling process, each has its own
+     * copy of @b integrand and @b digitalNet, and base matrix is shared
+     * until written, or by shared memory cache of DigitalNet if enabled.
+     * Digital shifts are drawn in the calling process in the same order
+     * as quasi_monte_carlo_integration(), and values of jobs are
+     * combined in order of job.
+     *
+     * Each randomization is split into @b split ranges of consecutive
+     * points, and a job is a range. When @b split is 1, a job is a
+     * randomization and the result is the same as
+     * quasi_monte_carlo_integration(). Otherwise sums of ranges are
+     * added in order of range, so the result does not depend on number
+     * of processes, but may differ from the serial one by rounding error.
+     *
+     * @tperm I integrand function class
+     *
+     * @param[in] N number of trials.
+     * @param[in] integrand integrand function class, which should have
+     * double operator()(double[]) or batch operator() of BatchIntegrand.h.
+     * Changes of its state in workers are not seen by the caller.
+     * @param[in,out] digitalNet digital net class, digital shifts are
+     * drawn from it. Jobs run on a cursor sharing its base matrix, so
+     * its state is the same as after
+     * parallel_quasi_monte_carlo_integration().
+     * @param[in,out] pool worker processes.
+     * @param[in] probability expected probability of returned value x is
+     * between x - absolute error and x + absolute error. this should be
+     * one of {95, 99, 999, 9999}.
+     * @param[in] split number of ranges of a randomization, power of 2
+     * not greater than 2<sup>m</sup>.
+     * @return MCQMCResult.
+     * @throw runtime_error when @b split is wrong or a worker fails.
+     */
+    template<typename I>
+        MCQMCResult process_quasi_monte_carlo_integration(
+            uint32_t N,
+            I& integrand,
+            DigitalNet<uint64_t>& digitalNet,
+            ProcessPool& pool,
+            int probability = 99,
+            uint32_t split = 1)
+    {
+        uint32_t s = digitalNet.getS();
+        uint64_t size = UINT64_C(1) << digitalNet.getM();
+        if (split == 0 || split > size || (split & (split - 1)) != 0) {
+            //throw invalid_argument("split should be power of 2 <= 2^m");
+            throw "split should be power of 2 <= 2^m";
+        }
+        uint32_t count = N == 0 ? 1 : N;
+        std::vector<uint64_t> shifts;
+        qmc_draw_shifts(digitalNet, count, shifts);
+        // jobs run on a cursor, as the thread version, also when jobs
+        // run in this process.
+        std::shared_ptr<const DigitalNet<uint64_t> >
+            prototype(&digitalNet, [](const DigitalNet<uint64_t> *) {});
+        DigitalNet<uint64_t> cursor(prototype);
+        uint64_t range = size / split;
+        std::vector<double> values(static_cast<size_t>(count) * split);
+        pool.run(values.size(), sizeof(double),
+                 [&](unsigned, size_t index, void * result) {
+                     const uint64_t * shift = &shifts[index / split * s];
+                     double * value = static_cast<double *>(result);
+                     if (split == 1) {
+                         *value = qmc_randomization_mean(integrand,
+                                                         cursor, shift);
+                     } else {
+                         uint64_t first = index % split * range;
+                         BatchFeeder<I> feeder(integrand, s);
+                         *value = qmc_partial_sum(feeder, cursor, shift,
+                                                  first, first + range);
+                     }
+                 }, &values[0]);
+        OnlineVariance eachintval;
+        for (uint32_t r = 0; r < count; r++) {
+            if (split == 1) {
+                eachintval.addData(values[r]);
+                continue;
+            }
+            double sum = 0;
+            for (uint32_t b = 0; b < split; b++) {
+                sum += values[static_cast<size_t>(r) * split + b];
+            }
+            eachintval.addData(sum / static_cast<double>(size));
+        }
+        return MCQMCResult({eachintval.getMean(),
+                    eachintval.absErr(probability)});
+    }
 }
 #endif // MCQMC_INTEGRATION_HPP
@@ -0,0 +1,96 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_MT_BLOCK_RANDOM_H
+#define MCQMC_INTEGRATION_MT_BLOCK_RANDOM_H
+/**
+ * @file MTBlockRandom.h
+ *
+ * @brief MT19937-64 generating random numbers block by block.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/MersenneTwister64.h>
+#include <inttypes.h>
+#include <cstddef>
+
+namespace MCQMCIntegration {
+    /**
+     * MT19937-64 which updates whole state at once and keeps tempered
+     * outputs in a buffer. Loops over the state have no dependency
+     * between iterations and are vectorized by compilers. 64-bit outputs
+     * are the same as std::mt19937_64 of the same seed.
+     *
+     * fill() converts outputs x to doubles (x >> 11) * 2<sup>-53</sup>
+     * in [0, 1), which is not the same as
+     * std::uniform_real_distribution.
+     */
+    class MTBlockRandom {
+    public:
+        typedef uint64_t result_type;
+
+        /**
+         * constructor, initialized as std::mt19937_64(seed).
+         * @param[in] seed seed.
+         */
+        explicit MTBlockRandom(uint64_t seed
+                               = MersenneTwister64::default_seed);
+
+        /**
+         * constructor, which generates the same sequence as @b rand.
+         * Use MersenneTwister64::jump() to make independent streams.
+         * @param[in] rand generator.
+         */
+        explicit MTBlockRandom(const MersenneTwister64& rand);
+
+        /**
+         * initialize as std::mt19937_64::seed(seed).
+         * @param[in] seed seed.
+         */
+        void seed(uint64_t seed);
+
+        result_type operator()() {
+            if (pos == size) {
+                generate();
+            }
+            return out[pos++];
+        }
+
+        static constexpr result_type min() {
+            return 0;
+        }
+
+        static constexpr result_type max() {
+            return UINT64_MAX;
+        }
+
+        /**
+         * fill @b array by 64-bit random numbers.
+         * @param[out] array output.
+         * @param[in] n number of outputs.
+         */
+        void fill(uint64_t array[], size_t n);
+
+        /**
+         * fill @b array by random doubles in [0, 1).
+         * @param[out] array output.
+         * @param[in] n number of outputs.
+         */
+        void fill(double array[], size_t n);
+    private:
+        static const int size = MersenneTwister64::state_size;
+        void generate();
+        uint64_t state[size];
+        uint64_t out[size];
+        int pos;
+    };
+}
+#endif // MCQMC_INTEGRATION_MT_BLOCK_RANDOM_H
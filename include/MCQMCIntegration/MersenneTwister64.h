@@ -0,0 +1,158 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_MERSENNE_TWISTER64_H
+#define MCQMC_INTEGRATION_MERSENNE_TWISTER64_H
+/**
+ * @file MersenneTwister64.h
+ *
+ * @brief 64-bit Mersenne Twister with jump ahead.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <inttypes.h>
+#include <cstddef>
+#include <vector>
+
+namespace MCQMCIntegration {
+    /**
+     * MT19937-64, which generates the same sequence as std::mt19937_64
+     * of the same seed, and can jump ahead in its sequence.
+     *
+     * Jump ahead is done by polynomial arithmetic, see
+     * H. Haramoto, M. Matsumoto, T. Nishimura, F. Panneton and
+     * P. L'Ecuyer, "Efficient Jump Ahead for F2-Linear Random Number
+     * Generators", INFORMS Journal on Computing 20(3), 2008.
+     *
+     * This class satisfies UniformRandomBitGenerator.
+     */
+    class MersenneTwister64 {
+    public:
+        typedef uint64_t result_type;
+        static const int state_size = 312;
+        static const int shift_size = 156;
+        static const uint64_t default_seed = 5489;
+
+        /**
+         * constructor, initialized as std::mt19937_64(seed).
+         * @param[in] seed seed.
+         */
+        explicit MersenneTwister64(uint64_t seed = default_seed) {
+            this->seed(seed);
+        }
+
+        /**
+         * initialize as std::mt19937_64::seed(seed).
+         * @param[in] seed seed.
+         */
+        void seed(uint64_t seed);
+
+        /**
+         * generate next 64-bit random number.
+         * @return random number.
+         */
+        result_type operator()() {
+            int i = index;
+            int i1 = i + 1 == state_size ? 0 : i + 1;
+            int im = i + shift_size >= state_size
+                ? i + shift_size - state_size : i + shift_size;
+            uint64_t y = (state[i] & UINT64_C(0xFFFFFFFF80000000))
+                | (state[i1] & UINT64_C(0x7FFFFFFF));
+            uint64_t x = state[im] ^ (y >> 1)
+                ^ ((y & 1) ? UINT64_C(0xB5026F5AA96619E9) : 0);
+            state[i] = x;
+            index = i1;
+            x ^= (x >> 29) & UINT64_C(0x5555555555555555);
+            x ^= (x << 17) & UINT64_C(0x71D67FFFEDA60000);
+            x ^= (x << 37) & UINT64_C(0xFFF7EEE000000000);
+            x ^= (x >> 43);
+            return x;
+        }
+
+        static constexpr result_type min() {
+            return 0;
+        }
+
+        static constexpr result_type max() {
+            return UINT64_MAX;
+        }
+
+        /**
+         * skip @b steps outputs by generating them.
+         * @param[in] steps number of outputs skipped.
+         */
+        void discard(uint64_t steps);
+
+        /**
+         * skip @b steps outputs by polynomial jump ahead. The result is
+         * the same as discard(steps), and the cost does not depend on
+         * @b steps much.
+         * @param[in] steps number of outputs skipped.
+         */
+        void jump(uint64_t steps);
+
+        /**
+         * check two generators generate the same sequence.
+         * @param[in] that other generator.
+         * @return true if the same.
+         */
+        bool operator==(const MersenneTwister64& that) const;
+
+        bool operator!=(const MersenneTwister64& that) const {
+            return !(*this == that);
+        }
+
+        /**
+         * get internal state, from the oldest word.
+         * @param[out] array state_size words.
+         */
+        void getState(uint64_t array[]) const;
+
+        /**
+         * set internal state, from the oldest word.
+         * @param[in] array state_size words.
+         */
+        void setState(const uint64_t array[]);
+    private:
+        friend class MTJumpPolynomial;
+        void nextState();
+        void addState(const MersenneTwister64& that);
+        uint64_t state[state_size];
+        int index;
+    };
+
+    /**
+     * jump polynomial of MersenneTwister64, which is computed once and
+     * can be applied to many generators.
+     */
+    class MTJumpPolynomial {
+    public:
+        /**
+         * compute polynomial to skip @b steps outputs.
+         * @param[in] steps number of outputs skipped.
+         */
+        explicit MTJumpPolynomial(uint64_t steps);
+
+        /**
+         * make @b rand skip steps outputs.
+         * @param[in,out] rand generator.
+         */
+        void apply(MersenneTwister64& rand) const;
+
+        uint64_t getSteps() const {
+            return steps;
+        }
+    private:
+        uint64_t steps;
+        std::vector<uint64_t> poly;
+    };
+}
+#endif // MCQMC_INTEGRATION_MERSENNE_TWISTER64_H
@@ -0,0 +1,434 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_MULTILEVEL_H
+#define MCQMC_INTEGRATION_MULTILEVEL_H
+/**
+ * @file Multilevel.h
+ *
+ * @brief Multilevel Quasi Monte-Carlo integration.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+namespace MCQMCIntegration {
+    /**
+     * Result of a level of multilevel integration.
+     */
+    struct MLQMCLevelResult {
+        /** estimate of difference of the level */
+        double value;
+        /** absolute error of the estimate */
+        double error;
+        /** dimension of the level */
+        uint32_t s;
+        /** number of randomizations */
+        uint32_t N;
+        /** F2 dimension */
+        uint32_t m;
+        /** number of integrand evaluations */
+        uint64_t evaluations;
+        /** cost of a point used for allocation */
+        double cost;
+    };
+
+    /**
+     * Result of multilevel integration.
+     */
+    struct MLQMCResult {
+        /** sum of estimates of levels */
+        double value;
+        /** absolute error of the sum */
+        double error;
+        /** number of integrand evaluations of all levels */
+        uint64_t evaluations;
+        /** true if the target is met */
+        bool converged;
+        /** results of levels */
+        std::vector<MLQMCLevelResult> levels;
+    };
+
+    /*
+     * integrand of a level, double operator()(uint32_t, const double[])
+     * of multilevel integrand with the level fixed.
+     */
+    template<typename I>
+        class LevelIntegrand {
+    public:
+        LevelIntegrand(I& integrand, uint32_t level)
+            : integrand(integrand) {
+            this->level = level;
+        }
+        double operator()(const double p[]) {
+            return integrand(level, p);
+        }
+    private:
+        I& integrand;
+        uint32_t level;
+    };
+
+    /*
+     * a level of multilevel integration, N randomizations of 2^m points
+     * of the digital net of dimension of the level.
+     *
+     * Points are added as adaptive_quasi_monte_carlo_integration(): m is
+     * increased first reusing the values of first points, then N is
+     * doubled when m reaches maxM. Digital shifts are drawn from a
+     * generator of the level, so they do not depend on other levels.
+     */
+    template<typename I>
+        class MultilevelState {
+    public:
+        MultilevelState(I& integrand, uint32_t level, DigitalNetID id,
+                        uint32_t s, const MCQMCTolerance& tolerance,
+                        double cost)
+            : levelIntegrand(integrand, level), feeder(levelIntegrand, s) {
+            this->id = id;
+            this->s = s;
+            m = tolerance.minM;
+            if (m == 0 || m < getMMin(id, s)) {
+                m = getMMin(id, s);
+            }
+            maxM = getMMax(id, s);
+            if (tolerance.maxM != 0 && tolerance.maxM < maxM) {
+                maxM = std::max(tolerance.maxM, m);
+            }
+            N = std::max(tolerance.minTrials, UINT32_C(2));
+            std::seed_seq seq({static_cast<uint32_t>(tolerance.seed),
+                        static_cast<uint32_t>(tolerance.seed >> 32),
+                        level});
+            mt.seed(seq);
+            fixedCost = cost;
+            evaluations = 0;
+            seconds = 0;
+            done = 0;
+            net = DigitalNetRegistry::getInstance().get(id, s, m);
+            cursor.reset(new DigitalNet<uint64_t>(net));
+        }
+
+        /*
+         * reduce randomizations before the first evaluation.
+         */
+        void limitTrials(uint32_t trials) {
+            if (done == 0 && trials < N) {
+                N = trials;
+            }
+        }
+
+        /*
+         * evaluate randomizations not done yet.
+         */
+        void evaluate() {
+            Timer timer(this);
+            shifts.resize(static_cast<size_t>(N) * s);
+            sums.resize(N);
+            for (uint32_t r = done; r < N; r++) {
+                for (uint32_t j = 0; j < s; j++) {
+                    shifts[r * s + j] = mt();
+                }
+                sums[r] = qmc_partial_sum(feeder, *cursor, &shifts[r * s],
+                                          0, UINT64_C(1) << m);
+                evaluations += UINT64_C(1) << m;
+            }
+            done = N;
+        }
+
+        /*
+         * number of evaluations of grow().
+         */
+        uint64_t growEvaluations() {
+            uint64_t points = static_cast<uint64_t>(N) << m;
+            if (m < maxM) {
+                if (!next) {
+                    next = DigitalNetRegistry::getInstance()
+                        .get(id, s, m + 1);
+                    reuse = qmc_same_prefix(*net, *next);
+                }
+                if (!reuse) {
+                    points *= 2;
+                }
+            } else if (N > UINT32_MAX / 2) {
+                return UINT64_MAX;
+            }
+            return points;
+        }
+
+        /*
+         * double number of points, by m or N.
+         */
+        void grow() {
+            if (m >= maxM) {
+                N *= 2;
+                evaluate();
+                return;
+            }
+            uint64_t points = growEvaluations();
+            Timer timer(this);
+            net = next;
+            next.reset();
+            cursor.reset(new DigitalNet<uint64_t>(net));
+            for (uint32_t r = 0; r < N; r++) {
+                if (reuse) {
+                    sums[r] += qmc_partial_sum(feeder, *cursor,
+                                               &shifts[r * s],
+                                               UINT64_C(1) << m,
+                                               UINT64_C(1) << (m + 1));
+                } else {
+                    sums[r] = qmc_partial_sum(feeder, *cursor,
+                                              &shifts[r * s],
+                                              0, UINT64_C(1) << (m + 1));
+                }
+            }
+            evaluations += points;
+            m++;
+        }
+
+        /*
+         * statistics of means of randomizations.
+         */
+        OnlineVariance statistics() const {
+            OnlineVariance eachintval;
+            for (uint32_t r = 0; r < N; r++) {
+                eachintval.addData(sums[r] / std::ldexp(1.0, m));
+            }
+            return eachintval;
+        }
+
+        /*
+         * cost of a point, given or measured.
+         */
+        double cost() const {
+            if (fixedCost > 0) {
+                return fixedCost;
+            }
+            if (evaluations == 0 || seconds <= 0) {
+                // too fast to be measured
+                return 1e-9;
+            }
+            return seconds / static_cast<double>(evaluations);
+        }
+
+        uint32_t getS() const {
+            return s;
+        }
+        uint32_t getN() const {
+            return N;
+        }
+        uint32_t getM() const {
+            return m;
+        }
+        uint64_t getEvaluations() const {
+            return evaluations;
+        }
+    private:
+        MultilevelState(const MultilevelState&);
+        MultilevelState& operator=(const MultilevelState&);
+        struct Timer {
+            explicit Timer(MultilevelState * state) {
+                this->state = state;
+                start = std::chrono::steady_clock::now();
+            }
+            ~Timer() {
+                std::chrono::duration<double> elapsed
+                    = std::chrono::steady_clock::now() - start;
+                state->seconds += elapsed.count();
+            }
+            MultilevelState * state;
+            std::chrono::steady_clock::time_point start;
+        };
+        LevelIntegrand<I> levelIntegrand;
+        BatchFeeder<LevelIntegrand<I> > feeder;
+        DigitalNetID id;
+        uint32_t s;
+        uint32_t m;
+        uint32_t maxM;
+        uint32_t N;
+        uint32_t done;
+        std::mt19937_64 mt;
+        SharedDigitalNet net;
+        SharedDigitalNet next;
+        bool reuse;
+        std::unique_ptr<DigitalNet<uint64_t> > cursor;
+        std::vector<uint64_t> shifts;
+        // sums[r] is sum of first 2^m points of randomization r
+        std::vector<double> sums;
+        double fixedCost;
+        uint64_t evaluations;
+        double seconds;
+    };
+
+    /**
+     * Multilevel Quasi Monte-Carlo Integration.
+     *
+     * Expectation of the finest level P<sub>L</sub> is the sum of
+     * expectations of differences Y<sub>l</sub> = P<sub>l</sub> -
+     * P<sub>l-1</sub>, Y<sub>0</sub> = P<sub>0</sub>, which are
+     * integrated separately with the digital net of dimension of each
+     * level. The integrand has
+     * @code
+     * double operator()(uint32_t level, const double p[])
+     * @endcode
+     * which returns Y<sub>level</sub> at point @b p of dimension
+     * dimensions[level].
+     *
+     * All levels start with tolerance.minTrials randomizations of
+     * 2<sup>minM</sup> points. Then the level of the largest variance
+     * of its estimate per cost of doubling its points is doubled, by m
+     * first then by randomizations, until the error of the sum meets the
+     * target or the budget is exhausted. The first evaluation is in the
+     * budget, randomizations at first are reduced to fit in
+     * maxEvaluations. This is the allocation of
+     * M. B. Giles and B. J. Waterhouse, "Multilevel quasi-Monte Carlo
+     * path simulation", Radon Series Comp. Appl. Math. 8, 2009. Number
+     * of levels is fixed by the caller, bias of the finest level is not
+     * estimated.
+     *
+     * Cost of a point of a level is measured by time, or given by
+     * @b costs. With measured costs, the allocation and then the result
+     * may change from run to run.
+     *
+     * @tperm I multilevel integrand function class.
+     *
+     * @param[in,out] integrand multilevel integrand.
+     * @param[in] digitalNetId ID of pre-defined digital net.
+     * @param[in] dimensions dimension of each level.
+     * @param[in] tolerance target and budget, absolute error of the sum
+     * is the square root of sum of squares of errors of levels.
+     * @param[in] costs relative cost of a point of each level, empty
+     * means measured.
+     * @return MLQMCResult, converged is false if the budget is
+     * exhausted before the target is met.
+     * @throw runtime_error when neither target nor budget is given, no
+     * level is given, or maxEvaluations is less than two randomizations
+     * of all levels.
+     */
+    template<typename I>
+        MLQMCResult multilevel_quasi_monte_carlo_integration(
+            I& integrand,
+            DigitalNetID digitalNetId,
+            const std::vector<uint32_t>& dimensions,
+            const MCQMCTolerance& tolerance,
+            const std::vector<double>& costs = std::vector<double>())
+    {
+        if (tolerance.absolute <= 0 && tolerance.relative <= 0
+            && tolerance.maxEvaluations == 0 && tolerance.maxSeconds <= 0) {
+            //throw runtime_error("no tolerance nor budget!");
+            throw "no tolerance nor budget!";
+        }
+        if (dimensions.empty()) {
+            //throw invalid_argument("no level!");
+            throw "no level!";
+        }
+        std::chrono::steady_clock::time_point start
+            = std::chrono::steady_clock::now();
+        size_t L = dimensions.size();
+        std::vector<std::unique_ptr<MultilevelState<I> > > levels(L);
+        for (size_t l = 0; l < L; l++) {
+            double cost = l < costs.size() ? costs[l] : 0;
+            levels[l].reset(new MultilevelState<I>(
+                                integrand, static_cast<uint32_t>(l),
+                                digitalNetId, dimensions[l], tolerance,
+                                cost));
+        }
+        if (tolerance.maxEvaluations > 0) {
+            // the first evaluation is also in the budget
+            uint64_t points = 0;
+            for (size_t l = 0; l < L; l++) {
+                points += UINT64_C(1) << levels[l]->getM();
+            }
+            uint64_t trials = tolerance.maxEvaluations / points;
+            if (trials < 2) {
+                //throw runtime_error("budget is less than the first evaluation!");
+                throw "budget is less than the first evaluation!";
+            }
+            if (trials > UINT32_MAX) {
+                trials = UINT32_MAX;
+            }
+            for (size_t l = 0; l < L; l++) {
+                levels[l]->limitTrials(static_cast<uint32_t>(trials));
+            }
+        }
+        for (size_t l = 0; l < L; l++) {
+            levels[l]->evaluate();
+        }
+        MLQMCResult result;
+        result.levels.resize(L);
+        for (;;) {
+            result.value = 0;
+            result.evaluations = 0;
+            double error2 = 0;
+            // variance of estimate of levels
+            std::vector<double> vars(L);
+            for (size_t l = 0; l < L; l++) {
+                MultilevelState<I>& level = *levels[l];
+                OnlineVariance eachintval = level.statistics();
+                MLQMCLevelResult& lr = result.levels[l];
+                lr.value = eachintval.getMean();
+                lr.error = eachintval.absErr(tolerance.probability);
+                lr.s = level.getS();
+                lr.N = level.getN();
+                lr.m = level.getM();
+                lr.evaluations = level.getEvaluations();
+                lr.cost = level.cost();
+                vars[l] = eachintval.unbiasedVar() / level.getN();
+                result.value += lr.value;
+                result.evaluations += lr.evaluations;
+                error2 += lr.error * lr.error;
+            }
+            result.error = std::sqrt(error2);
+            result.converged
+                = (tolerance.absolute > 0
+                   && result.error <= tolerance.absolute)
+                || (tolerance.relative > 0
+                    && result.error <= tolerance.relative
+                    * std::fabs(result.value));
+            if (result.converged) {
+                return result;
+            }
+            std::chrono::duration<double> elapsed
+                = std::chrono::steady_clock::now() - start;
+            if (tolerance.maxSeconds > 0
+                && elapsed.count() >= tolerance.maxSeconds) {
+                return result;
+            }
+            // doubling points reduces variance by half or more
+            size_t best = L;
+            double bestGain = -1;
+            uint64_t bestEvaluations = 0;
+            for (size_t l = 0; l < L; l++) {
+                uint64_t ev = levels[l]->growEvaluations();
+                if (ev == UINT64_MAX) {
+                    continue;
+                }
+                double gain = vars[l] / (levels[l]->cost() * ev);
+                if (gain > bestGain) {
+                    best = l;
+                    bestGain = gain;
+                    bestEvaluations = ev;
+                }
+            }
+            if (best == L
+                || (tolerance.maxEvaluations > 0
+                    && result.evaluations + bestEvaluations
+                    > tolerance.maxEvaluations)) {
+                return result;
+            }
+            levels[best]->grow();
+        }
+    }
+}
+#endif // MCQMC_INTEGRATION_MULTILEVEL_H
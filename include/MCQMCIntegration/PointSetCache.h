@@ -0,0 +1,168 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_POINT_SET_CACHE_H
+#define MCQMC_INTEGRATION_POINT_SET_CACHE_H
+/**
+ * @file PointSetCache.h
+ *
+ * @brief Cache of generated point sets in memory mapped files.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <MCQMCIntegration/DigitalNet.h>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace MCQMCIntegration {
+    class MappedFile;
+
+    /**
+     * element type of stored point set.
+     */
+    enum PointFormat {
+        /** double, the same points as DigitalNet::getPoint(). */
+        POINT_DOUBLE = 0,
+        /** float, half size, points are rounded. */
+        POINT_FLOAT = 1,
+        /** upper 53 bits of shifted point as 64-bit integer. */
+        POINT_INTEGER = 2
+    };
+
+    /**
+     * All 2<sup>m</sup> points of a randomization of digital net,
+     * in gray code order, which is the order DigitalNet generates.
+     */
+    class MappedPointSet {
+    public:
+        ~MappedPointSet();
+
+        uint32_t getS() const {
+            return s;
+        }
+
+        uint32_t getM() const {
+            return m;
+        }
+
+        /**
+         * @return number of points, 2<sup>m</sup>.
+         */
+        uint64_t size() const {
+            return UINT64_C(1) << m;
+        }
+
+        PointFormat getFormat() const {
+            return format;
+        }
+
+        /**
+         * get raw data, @b index th point starts at @b index * s th
+         * element.
+         * @return double, float or uint64_t array depending on format.
+         */
+        const void * data() const {
+            return points;
+        }
+
+        /**
+         * get a point, only for POINT_DOUBLE.
+         * @param[in] index index of point.
+         * @return point, NULL if format is not POINT_DOUBLE.
+         */
+        const double * getPoint(uint64_t index) const {
+            if (format != POINT_DOUBLE) {
+                return NULL;
+            }
+            return static_cast<const double *>(points) + index * s;
+        }
+
+        /**
+         * get a point in double of any format.
+         * @param[in] index index of point.
+         * @param[out] point array of @b s elements.
+         */
+        void getPoint(uint64_t index, double point[]) const;
+    private:
+        friend class PointSetCache;
+        MappedPointSet(const MappedPointSet&);
+        MappedPointSet& operator=(const MappedPointSet&);
+        MappedPointSet();
+        uint32_t s;
+        uint32_t m;
+        PointFormat format;
+        const void * points;
+        MappedFile * file;
+    };
+
+    /**
+     * Cache of point sets in files of a directory.
+     *
+     * A point set is identified by hash of base matrix and digital shift,
+     * so that a randomization of the same net, scramble and seed is
+     * served from the file. Files are used in least recently used order
+     * and removed when total size of files exceeds the size cap.
+     * Files can be shared by processes; a file is written to temporary
+     * name and renamed.
+     */
+    class PointSetCache {
+    public:
+        /**
+         * constructor.
+         * @param[in] directory directory of cache files, should exist.
+         * @param[in] maxBytes size cap of total size of files.
+         */
+        explicit PointSetCache(const std::string& directory,
+                               uint64_t maxBytes = UINT64_C(1) << 30);
+
+        /**
+         * get point set of current randomization of @b net, which is
+         * made and stored if not in cache. State of @b net is not changed
+         * except that all dimensions are made in lazy mode.
+         * @param[in,out] net digital net.
+         * @param[in] format element type.
+         * @return point set.
+         * @throw runtime_error when can't write or map the file.
+         */
+        std::shared_ptr<const MappedPointSet> get(DigitalNet<uint64_t>& net,
+                                                  PointFormat format
+                                                  = POINT_DOUBLE);
+
+        /**
+         * remove least recently used files until total size is not
+         * greater than size cap.
+         */
+        void cleanup();
+
+        /**
+         * remove all files of cache.
+         */
+        void clear();
+
+        uint64_t getMaxBytes() const {
+            return maxBytes;
+        }
+
+        uint64_t getHits();
+        uint64_t getMisses();
+    private:
+        PointSetCache(const PointSetCache&);
+        PointSetCache& operator=(const PointSetCache&);
+        void removeFiles(uint64_t limit);
+        std::string directory;
+        uint64_t maxBytes;
+        std::mutex mtx;
+        uint64_t hits;
+        uint64_t misses;
+    };
+}
+#endif // MCQMC_INTEGRATION_POINT_SET_CACHE_H
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_PROCESS_POOL_H
+#define MCQMC_INTEGRATION_PROCESS_POOL_H
+/**
+ * @file ProcessPool.h
+ *
+ * @brief Worker processes on a node.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <inttypes.h>
+#include <cstddef>
+#include <functional>
+
+namespace MCQMCIntegration {
+    /**
+     * Pool of worker processes, for integrands which are not thread
+     * safe.
+     *
+     * Each run() forks worker processes, which are copies of the
+     * calling process, so that global states of integrand are separated
+     * and read only data, like base matrix of digital net, are shared
+     * until they are written. Workers take indexes of jobs by an atomic
+     * counter in anonymous shared memory, and write results of jobs to
+     * shared memory, which are copied to the caller.
+     *
+     * Where fork() is not available, jobs run in the calling process.
+     * @note run() should be called when other threads of the process
+     * hold no lock, as only the calling thread is copied.
+     */
+    class ProcessPool {
+    public:
+        /**
+         * job called by run() in a worker process, worker is index of
+         * worker process, index is index of job and result is area of
+         * the result of the job.
+         */
+        typedef std::function<void(unsigned worker, size_t index,
+                                   void * result)> Job;
+
+        /**
+         * constructor.
+         * @param[in] processes number of worker processes, 0 means the
+         * number of hardware threads.
+         */
+        explicit ProcessPool(unsigned processes = 0);
+
+        /**
+         * get number of worker processes.
+         * @return number of worker processes.
+         */
+        unsigned size() const {
+            return processes;
+        }
+
+        /**
+         * call job(worker, i, result) for i = 0 .. count - 1 in worker
+         * processes and wait for them.
+         * @param[in] count number of jobs.
+         * @param[in] resultSize size of result of a job in bytes.
+         * @param[in] job job, changes of memory other than result are
+         * not seen by the caller.
+         * @param[out] results @b count * @b resultSize bytes, result of
+         * job i is at i * resultSize.
+         * @throw runtime_error when a job throws an exception or a
+         * worker process dies, or can't make worker processes.
+         */
+        void run(size_t count, size_t resultSize, const Job& job,
+                 void * results);
+    private:
+        unsigned processes;
+    };
+}
+#endif // MCQMC_INTEGRATION_PROCESS_POOL_H
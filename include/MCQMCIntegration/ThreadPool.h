@@ -0,0 +1,164 @@
+#pragma once
+#ifndef MCQMC_INTEGRATION_THREAD_POOL_H
+#define MCQMC_INTEGRATION_THREAD_POOL_H
+/**
+ * @file ThreadPool.h
+ *
+ * @brief Persistent pool of worker threads.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <inttypes.h>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <deque>
+
+namespace MCQMCIntegration {
+    /**
+     * Pool of worker threads, which are created at construction and
+     * reused by run().
+     */
+    class ThreadPool {
+    public:
+        /**
+         * job called by run(), worker is index of worker thread and
+         * index is index of job.
+         */
+        typedef std::function<void(unsigned worker, size_t index)> Job;
+
+        /**
+         * task called by post(), worker is index of worker thread.
+         */
+        typedef std::function<void(unsigned worker)> Task;
+
+        /**
+         * start worker threads.
+         * @param[in] threads number of worker threads, 0 means the number
+         * of hardware threads.
+         * @param[in] cpus CPU affinity hint, worker i is bound to CPU
+         * cpus[i % cpus.size()] if supported. Empty means no binding.
+         */
+        explicit ThreadPool(unsigned threads = 0,
+                            const std::vector<int>& cpus
+                            = std::vector<int>());
+
+        /**
+         * stop and join worker threads.
+         */
+        ~ThreadPool();
+
+        /**
+         * get number of worker threads.
+         * @return number of worker threads.
+         */
+        unsigned size() const {
+            return static_cast<unsigned>(threads.size());
+        }
+
+        /**
+         * call job(worker, index) for index = 0 .. count - 1 on worker
+         * threads, and wait for all of them. Indexes are taken in
+         * increasing order. Exception thrown by a job is thrown here
+         * after all jobs end. Should not be called from a job.
+         * @param[in] count number of jobs.
+         * @param[in] job job.
+         */
+        void run(size_t count, const Job& job);
+
+        /**
+         * call task(worker) on a worker thread later, and return
+         * immediately. Tasks are taken in order of post, after jobs of
+         * run(). Exception thrown by a task is ignored. Tasks posted
+         * before destruction are done before worker threads stop.
+         * @param[in] task task.
+         */
+        void post(const Task& task);
+    private:
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+        void work(unsigned worker);
+        std::vector<std::thread> threads;
+        std::vector<int> cpus;
+        // one run() at a time
+        std::mutex runMtx;
+        std::mutex mtx;
+        std::condition_variable startCond;
+        std::condition_variable doneCond;
+        const Job * job;
+        size_t count;
+        size_t nextIndex;
+        size_t finished;
+        uint64_t generation;
+        bool stopping;
+        std::exception_ptr error;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * Work stealing scheduler of blocks 0 .. blocks - 1.
+     *
+     * Each slot owns a contiguous range of blocks at first, and takes
+     * chunks from the front of its range. When the range is empty, the
+     * slot steals the latter half of the range of other slot. Chunk size
+     * of a slot follows observed time per block reported by report(),
+     * so that a chunk takes about target seconds.
+     */
+    class StealingScheduler {
+    public:
+        /**
+         * constructor.
+         * @param[in] blocks number of blocks.
+         * @param[in] slots number of slots, usually size of thread pool.
+         * @param[in] target target time of a chunk in seconds.
+         */
+        StealingScheduler(size_t blocks, unsigned slots,
+                          double target = 0.0002);
+
+        /**
+         * take next chunk of @b slot.
+         * @param[in] slot slot index.
+         * @param[out] first first block of chunk.
+         * @param[out] last end of chunk, exclusive.
+         * @return false if no block remains.
+         */
+        bool next(unsigned slot, size_t * first, size_t * last);
+
+        /**
+         * report time spent for a chunk, to adapt chunk size.
+         * @param[in] slot slot index.
+         * @param[in] blocks number of blocks of the chunk.
+         * @param[in] seconds elapsed time.
+         */
+        void report(unsigned slot, size_t blocks, double seconds);
+    private:
+        StealingScheduler(const StealingScheduler&);
+        StealingScheduler& operator=(const StealingScheduler&);
+        struct Range {
+            std::mutex mtx;
+            size_t first;
+            size_t last;
+            size_t chunk;
+            double perBlock;
+        };
+        bool steal(unsigned slot);
+        std::vector<std::unique_ptr<Range> > ranges;
+        double target;
+    };
+}
+#endif // MCQMC_INTEGRATION_THREAD_POOL_H
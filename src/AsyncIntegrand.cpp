@@ -0,0 +1,79 @@
+/**
+ * @file AsyncIntegrand.cpp
+ *
+ * @brief Quasi Monte-Carlo integration of asynchronous integrand.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/AsyncIntegrand.h>
+
+using namespace std;
+
+namespace MCQMCIntegration {
+
+    AsyncCompletion::AsyncCompletion(size_t window)
+        : values(window == 0 ? 1 : window),
+          ready(window == 0 ? 1 : window, 0)
+    {
+        taken = 0;
+        completed = 0;
+    }
+
+    void AsyncCompletion::done(uint64_t index, double value)
+    {
+        unique_lock<mutex> lock(mtx);
+        values[index % values.size()] = value;
+        ready[index % ready.size()] = 1;
+        completed++;
+        cond.notify_all();
+    }
+
+    void AsyncCompletion::fail(uint64_t index, exception_ptr error)
+    {
+        unique_lock<mutex> lock(mtx);
+        if (!this->error) {
+            this->error = error;
+        }
+        ready[index % ready.size()] = 1;
+        completed++;
+        cond.notify_all();
+    }
+
+    double AsyncCompletion::take()
+    {
+        size_t slot = taken % ready.size();
+        unique_lock<mutex> lock(mtx);
+        while (!error && !ready[slot]) {
+            cond.wait(lock);
+        }
+        if (error) {
+            rethrow_exception(error);
+        }
+        ready[slot] = 0;
+        taken++;
+        return values[slot];
+    }
+
+    uint64_t AsyncCompletion::getCompleted()
+    {
+        unique_lock<mutex> lock(mtx);
+        return completed;
+    }
+
+    void AsyncCompletion::drain(uint64_t issued)
+    {
+        unique_lock<mutex> lock(mtx);
+        while (completed < issued) {
+            cond.wait(lock);
+        }
+    }
+}
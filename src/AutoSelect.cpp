@@ -0,0 +1,205 @@
+/**
+ * @file AutoSelect.cpp
+ *
+ * @brief Selection of digital net and its size by pilot integrations.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/AutoSelect.h>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    // fitted order is limited, extrapolation by few points is not
+    // reliable.
+    const double min_rate = 0.0;
+    const double max_rate = 3.0;
+    // order of Monte-Carlo, when it can't be fitted.
+    const double default_rate = 0.5;
+    // evaluations of the most accurate configuration, when the target
+    // can't be met and tolerance has no budget.
+    const double unbudgeted_evaluations = 16777216.0; // 2^24
+
+    /*
+     * least squares fit of log2(error) = a - rate * m.
+     */
+    double fit_rate(const MCQMCPilot& pilot)
+    {
+        double n = 0;
+        double sx = 0;
+        double sy = 0;
+        double sxx = 0;
+        double sxy = 0;
+        for (size_t k = 0; k < pilot.ms.size(); k++) {
+            double e = pilot.errors[k];
+            if (!(e > 0) || isinf(e)) {
+                continue;
+            }
+            double x = pilot.ms[k];
+            double y = log2(e);
+            n++;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        double d = n * sxx - sx * sx;
+        if (n < 2 || d <= 0) {
+            return default_rate;
+        }
+        double rate = -(n * sxy - sx * sy) / d;
+        if (rate < min_rate) {
+            return min_rate;
+        }
+        if (rate > max_rate) {
+            return max_rate;
+        }
+        return rate;
+    }
+
+    /*
+     * error of pilot of F2 dimension m, measured or extrapolated.
+     */
+    double pilot_error(const MCQMCPilot& pilot, double rate, uint32_t m)
+    {
+        for (size_t k = 0; k < pilot.ms.size(); k++) {
+            if (pilot.ms[k] == m && !isnan(pilot.errors[k])) {
+                return pilot.errors[k];
+            }
+        }
+        uint32_t last = pilot.ms.back();
+        double e = pilot.errors.back();
+        return e * exp2(-rate * (static_cast<double>(m) - last));
+    }
+
+    /*
+     * maximum number of randomizations of 2^m points in the budget.
+     */
+    double budget_trials(const MCQMCPilot& pilot,
+                         const MCQMCTolerance& tolerance, uint32_t m)
+    {
+        double n = UINT32_MAX;
+        double points = ldexp(1.0, m);
+        if (tolerance.maxEvaluations > 0) {
+            n = min(n, floor(tolerance.maxEvaluations / points));
+        }
+        if (tolerance.maxSeconds > 0 && pilot.secondsPerPoint > 0) {
+            n = min(n, floor(tolerance.maxSeconds
+                             / (points * pilot.secondsPerPoint)));
+        }
+        return n;
+    }
+}
+
+namespace MCQMCIntegration {
+
+    bool better_candidate(const MCQMCCandidate& a, const MCQMCCandidate& b,
+                          bool target)
+    {
+        double x = target ? a.seconds : a.error;
+        double y = target ? b.seconds : b.error;
+        // almost the same, lower WAFOM is better
+        if (fabs(x - y) <= 0.01 * max(x, y)
+            && !isnan(a.wafom) && !isnan(b.wafom)) {
+            return a.wafom < b.wafom;
+        }
+        return x < y;
+    }
+
+    bool select_candidate(const MCQMCPilot& pilot,
+                          const MCQMCTolerance& tolerance,
+                          MCQMCCandidate * candidate)
+    {
+        double rate = fit_rate(pilot);
+        double epsilon = 0;
+        if (tolerance.absolute > 0) {
+            epsilon = tolerance.absolute;
+        }
+        if (tolerance.relative > 0) {
+            epsilon = max(epsilon, tolerance.relative * fabs(pilot.value));
+        }
+        bool unbudgeted = tolerance.maxEvaluations == 0
+            && !(tolerance.maxSeconds > 0 && pilot.secondsPerPoint > 0);
+        bool found = false;
+        MCQMCCandidate best;
+        MCQMCCandidate accurate;
+        bool accurateFound = false;
+        for (uint32_t m = pilot.minM; m <= pilot.maxM; m++) {
+            double e = pilot_error(pilot, rate, m);
+            double limit = budget_trials(pilot, tolerance, m);
+            if (limit < pilot.trials) {
+                break;
+            }
+            MCQMCCandidate c;
+            c.id = pilot.id;
+            c.m = m;
+            c.rate = rate;
+            c.wafom = pilot.wafom;
+            c.tvalue = pilot.tvalue;
+            double points = ldexp(1.0, m);
+            // the most accurate in the budget, limit is UINT32_MAX
+            // without budget
+            double accurateN = limit;
+            if (unbudgeted) {
+                accurateN = floor(unbudgeted_evaluations / points);
+            }
+            if (accurateN >= pilot.trials) {
+                c.N = static_cast<uint32_t>(accurateN);
+                c.error = e * sqrt(pilot.trials / accurateN);
+                c.seconds = accurateN * points * pilot.secondsPerPoint;
+                if (!accurateFound || c.error < accurate.error) {
+                    accurate = c;
+                    accurateFound = true;
+                }
+            }
+            if (epsilon <= 0) {
+                continue;
+            }
+            // the fastest which meets the target
+            double n = pilot.trials;
+            if (e > epsilon) {
+                n = ceil(pilot.trials * (e / epsilon) * (e / epsilon));
+            }
+            if (isnan(n) || n > limit) {
+                continue;
+            }
+            c.N = static_cast<uint32_t>(n);
+            c.error = e * sqrt(pilot.trials / n);
+            c.seconds = n * points * pilot.secondsPerPoint;
+            if (!found || c.seconds < best.seconds) {
+                best = c;
+                found = true;
+            }
+        }
+        if (found) {
+            *candidate = best;
+            return true;
+        }
+        if (!accurateFound) {
+            // budget is less than pilot, the smallest configuration
+            accurate.id = pilot.id;
+            accurate.m = pilot.minM;
+            accurate.N = pilot.trials;
+            accurate.rate = rate;
+            accurate.error = pilot_error(pilot, rate, pilot.minM);
+            accurate.seconds = pilot.trials * ldexp(1.0, pilot.minM)
+                * pilot.secondsPerPoint;
+            accurate.wafom = pilot.wafom;
+            accurate.tvalue = pilot.tvalue;
+        }
+        *candidate = accurate;
+        return false;
+    }
+}
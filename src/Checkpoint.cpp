@@ -0,0 +1,163 @@
+/**
+ * @file Checkpoint.cpp
+ *
+ * @brief Checkpoint file of Quasi Monte-Carlo integration.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include "byte_order.h"
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include <MCQMCIntegration/Checkpoint.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#if defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    // "QCKP" and version 1
+    const uint64_t checkpoint_magic = UINT64_C(0x00000001504b4351);
+
+    // clock is read once in this number of points
+    const uint64_t clock_stride = 4096;
+}
+
+namespace MCQMCIntegration {
+
+    Checkpoint::Checkpoint(const CheckpointConfig& config, uint32_t N)
+        : config(config)
+    {
+        this->N = N;
+        reset();
+    }
+
+    void Checkpoint::reset()
+    {
+        points = 0;
+        nextCheck = clock_stride;
+        if (config.intervalPoints > 0 && config.intervalPoints < nextCheck) {
+            nextCheck = config.intervalPoints;
+        }
+        if (config.path.empty()) {
+            nextCheck = UINT64_MAX;
+        }
+        last = chrono::steady_clock::now();
+    }
+
+    bool Checkpoint::reached()
+    {
+        if (config.intervalPoints > 0 && points >= config.intervalPoints) {
+            return true;
+        }
+        if (config.intervalSeconds > 0) {
+            chrono::duration<double> elapsed
+                = chrono::steady_clock::now() - last;
+            if (elapsed.count() >= config.intervalSeconds) {
+                return true;
+            }
+        }
+        nextCheck = points + clock_stride;
+        if (config.intervalPoints > 0 && config.intervalPoints < nextCheck) {
+            nextCheck = config.intervalPoints;
+        }
+        return false;
+    }
+
+    bool Checkpoint::restore(DigitalNet<uint64_t>& net, uint32_t * cnt,
+                             uint64_t * index, OnlineVariance& eachintval,
+                             BlockVariance& intsum)
+    {
+        reset();
+        if (config.path.empty()) {
+            return false;
+        }
+        ifstream ifs(config.path.c_str(), ios::in | ios::binary);
+        if (!ifs) {
+            return false;
+        }
+        uint64_t magic;
+        uint64_t n;
+        uint64_t done;
+        uint64_t j;
+        if (!read_le64(ifs, &magic) || magic != checkpoint_magic
+            || !read_le64(ifs, &n) || n != N
+            || !read_le64(ifs, &done) || done >= N
+            || !read_le64(ifs, &j) || j > (UINT64_C(1) << net.getM())) {
+            return false;
+        }
+        uint8_t ov[OnlineVariance::serialized_size];
+        vector<uint8_t> bv(BlockVariance::serialized_size);
+        ifs.read(reinterpret_cast<char *>(ov), sizeof(ov));
+        ifs.read(reinterpret_cast<char *>(&bv[0]), bv.size());
+        OnlineVariance each;
+        BlockVariance sum;
+        if (!ifs
+            || !each.deserialize(ov, sizeof(ov))
+            || !sum.deserialize(&bv[0], bv.size())
+            || each.getN() != static_cast<int64_t>(done)
+            || sum.getN() != static_cast<int64_t>(j)
+            || !net.restoreState(ifs)) {
+            return false;
+        }
+        *cnt = static_cast<uint32_t>(done);
+        *index = j;
+        eachintval = each;
+        intsum = sum;
+        return true;
+    }
+
+    void Checkpoint::save(const DigitalNet<uint64_t>& net, uint32_t cnt,
+                          uint64_t index, const OnlineVariance& eachintval,
+                          const BlockVariance& intsum)
+    {
+        reset();
+        stringstream ts;
+#if defined(HAVE_UNISTD_H)
+        ts << config.path << ".tmp." << getpid();
+#else
+        ts << config.path << ".tmp";
+#endif
+        string temp = ts.str();
+        ofstream ofs(temp.c_str(), ios::out | ios::binary | ios::trunc);
+        write_le64(ofs, checkpoint_magic);
+        write_le64(ofs, N);
+        write_le64(ofs, cnt);
+        write_le64(ofs, index);
+        uint8_t ov[OnlineVariance::serialized_size];
+        vector<uint8_t> bv(BlockVariance::serialized_size);
+        eachintval.serialize(ov);
+        intsum.serialize(&bv[0]);
+        ofs.write(reinterpret_cast<char *>(ov), sizeof(ov));
+        ofs.write(reinterpret_cast<char *>(&bv[0]), bv.size());
+        net.saveState(ofs);
+        ofs.close();
+        if (ofs.fail() || rename(temp.c_str(), config.path.c_str()) != 0) {
+            remove(temp.c_str());
+            //throw runtime_error("can't write checkpoint!");
+            throw "can't write checkpoint!";
+        }
+    }
+
+    void Checkpoint::finish()
+    {
+        if (config.removeOnFinish && !config.path.empty()) {
+            remove(config.path.c_str());
+        }
+    }
+}
@@ -20,12 +20,19 @@
 #include "digital.h"
 #include "bit_operator.h"
 #include "sobolpoint.h"
+#include "mapped_file.h"
+#include "packed_base.h"
+#include "shared_net.h"
+#include "embedded_data.h"
+#include "byte_order.h"
 #include <MCQMCIntegration/DigitalNet.h>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <memory>
 #include <stdexcept>
 #include <stdlib.h>
 #include <cstring>
@@ -43,6 +50,12 @@ namespace {
 
     const int N = 64;
 
+    // number of dimensions made at once in lazy mode
+    const uint32_t lazy_chunk = 64;
+
+    // "DNST" and version 1
+    const uint64_t state_magic = UINT64_C(0x0000000154534e44);
+
     const string digital_net_path = "DIGITAL_NET_PATH";
     struct digital_net_name {
         std::string name;
@@ -94,29 +107,135 @@ namespace {
         return path;
     }
 
+    /*
+     * Sobol base matrix of small s and m is compiled into the library.
+     */
+    bool isEmbeddedSobol(uint32_t s, uint32_t m)
+    {
+        return s <= embedded_sobol_s && m <= embedded_sobol_m;
+    }
+
+    template<typename U>
+    void copyEmbeddedSobol(uint32_t s, uint32_t m, U base[])
+    {
+        for (uint32_t i = 0; i < m; i++) {
+            const uint64_t * row = &embedded_sobol_base[i * embedded_sobol_s];
+            for (uint32_t j = 0; j < s; j++) {
+                if (sizeof(U) * 8  == 32) {
+                    base[i * s + j] = static_cast<U>((row[j] >> 32)
+                                                     & UINT32_C(0xffffffff));
+                } else {
+                    base[i * s + j] = static_cast<U>(row[j]);
+                }
+            }
+        }
+    }
+
+    /*
+     * search embedded database, the same as select_digital_net_data,
+     * a net of the same s and the smallest F2 dimension >= m is used.
+     */
+    template<typename U>
+    bool selectEmbeddedNet(DigitalNetID id, uint32_t s, uint32_t m,
+                           U base[],
+                           int64_t * tvalue, double * wafom)
+    {
+        const int bitsize = sizeof(U) * 8;
+        for (size_t k = 0; k < embedded_nets_size; k++) {
+            const embedded_net_t& net = embedded_nets[k];
+            if (net.id == static_cast<int>(id) && net.bitsize == bitsize
+                && net.s == s && net.m >= m) {
+                for (size_t i = 0; i < static_cast<size_t>(s) * m; i++) {
+                    base[i] = static_cast<U>(net.data[i]);
+                }
+                *tvalue = net.tvalue;
+                *wafom = net.wafom;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isEmbeddedComplete(DigitalNetID id)
+    {
+        for (size_t k = 0; k < embedded_complete_ids_size; k++) {
+            if (embedded_complete_ids[k] == static_cast<int>(id)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * s range of @b id from embedded database, returns false when
+     * the database should be asked.
+     */
+    bool getEmbeddedSMinMax(DigitalNetID id, int * min, int * max)
+    {
+        if (!isEmbeddedComplete(id)) {
+            return false;
+        }
+        bool found = false;
+        for (size_t k = 0; k < embedded_nets_size; k++) {
+            const embedded_net_t& net = embedded_nets[k];
+            if (net.id != static_cast<int>(id)) {
+                continue;
+            }
+            int s = static_cast<int>(net.s);
+            if (!found || s < *min) {
+                *min = s;
+            }
+            if (!found || s > *max) {
+                *max = s;
+            }
+            found = true;
+        }
+        return found;
+    }
+
+    /*
+     * m range of @b id and @b s from embedded database, returns false
+     * when the database should be asked.
+     */
+    bool getEmbeddedMMinMax(DigitalNetID id, uint32_t s, int * min, int * max)
+    {
+        if (!isEmbeddedComplete(id)) {
+            return false;
+        }
+        bool found = false;
+        for (size_t k = 0; k < embedded_nets_size; k++) {
+            const embedded_net_t& net = embedded_nets[k];
+            if (net.id != static_cast<int>(id) || net.s != s) {
+                continue;
+            }
+            int m = static_cast<int>(net.m);
+            if (!found || m < *min) {
+                *min = m;
+            }
+            if (!found || m > *max) {
+                *max = m;
+            }
+            found = true;
+        }
+        return found;
+    }
+
     template<typename U>
     int readSobolBase(const string& path, uint32_t s, uint32_t m, U base[])
     {
-        ifstream ifs(path, ios::in | ios::binary);
-        if (!ifs) {
+        if (isEmbeddedSobol(s, m)) {
+            copyEmbeddedSobol(s, m, base);
+            return 0;
+        }
+        SobolColumnReader reader(s, m);
+        if (!reader.open(path)) {
             cerr << "can't open:" << path << endl;
             return -1;
         }
-        uint64_t data[s * m];
-        bool r = get_sobol_base(ifs, s, m, data);
-        if (!r) {
+        // columns are written directly into base
+        if (!reader.read(s, base)) {
             return -1;
         }
-        if (sizeof(U) * 8  == 32) {
-            for (size_t i = 0; i < s * m; i++) {
-                base[i] = static_cast<U>((data[i] >> 32)
-                                         & UINT32_C(0xffffffff));
-            }
-        } else {
-            for (size_t i = 0; i < s * m; i++) {
-                base[i] = data[i];
-            }
-        }
         return 0;
     }
 
@@ -124,27 +243,53 @@ namespace {
     int readInterlacedSobolBase(const string& path, uint32_t s, uint32_t m,
                                 U base[])
     {
-        ifstream ifs(path, ios::in | ios::binary);
-        if (!ifs) {
+        InterlacedSobolColumnReader reader(s, m);
+        if (!reader.open(path)) {
             cerr << "can't open:" << path << endl;
             return -1;
         }
-        uint64_t data[s * m];
-        bool r = get_interlaced_sobol_base(ifs, s, m, data);
-        if (!r) {
+        // columns are written directly into base
+        if (!reader.read(s, base)) {
             return -1;
         }
-        if (sizeof(U) * 8  == 32) {
-            for (size_t i = 0; i < s * m; i++) {
-                base[i] = static_cast<U>((data[i] >> 32)
-                                         & UINT32_C(0xffffffff));
+        return 0;
+    }
+
+    /*
+     * open column reader for lazy mode, returns NULL when @b id is not
+     * a Sobol type point set.
+     */
+    ColumnReader * openColumnReader(DigitalNetID id, uint32_t s, uint32_t m)
+    {
+        string name = digital_net_name_data[id].abb;
+        switch (id) {
+        case SOBOL: {
+            SobolColumnReader * reader = new SobolColumnReader(s, m);
+            string path = makePath(name, ".dat");
+            if (!reader->open(path)) {
+                cerr << "can't open:" << path << endl;
+                delete reader;
+                return NULL;
             }
-        } else {
-            for (size_t i = 0; i < s * m; i++) {
-                base[i] = data[i];
+            return reader;
+        }
+        case ISOBOL_A2:
+        case ISOBOL_A3:
+        case ISOBOL_A4:
+        case ISOBOL_A5: {
+            InterlacedSobolColumnReader * reader
+                = new InterlacedSobolColumnReader(s, m);
+            string path = makePath(name, "_Bs53.col");
+            if (!reader->open(path)) {
+                cerr << "can't open:" << path << endl;
+                delete reader;
+                return NULL;
             }
+            return reader;
+        }
+        default:
+            return NULL;
         }
-        return 0;
     }
 
 #if 0
@@ -171,53 +316,40 @@ namespace {
         return 0;
     }
 #endif
-    template<typename U>
-    int read_digital_net_data(std::istream& is, int n,
+    template<typename S, typename U>
+    int read_digital_net_data(S& scanner, int n,
                               uint32_t s, uint32_t m,
                               U base[],
                               int64_t * tvalue, double * wafom)
     {
-        uint64_t data[s * m];
         uint64_t tmp;
-        uint32_t i = 0;
-        uint32_t j = 0;
-        for (i = 0; i < m; i++) {
-            for (j = 0; j < s; j++) {
-                if (!is) {
+        for (uint32_t i = 0; i < m; i++) {
+            for (uint32_t j = 0; j < s; j++) {
+                if (!scanner.next(tmp)) {
                     cerr << "too less data i = " << dec << i
                          << " j = " << j
                          << " s = " << s << " m = " << m
                          << endl;
                     return -1;
                 }
-                is >> tmp;
-                data[i * s + j] = tmp;
+                if (n == sizeof(U) * 8) {
+                    base[i * s + j] = static_cast<U>(tmp);
+                } else if (n == 32) { // U is uint64_t
+                    base[i * s + j] = static_cast<U>(tmp << 32);
+                } else { // n == 64 U is uint32_t
+                    base[i * s + j] = static_cast<U>((tmp >> 32)
+                                                     & UINT32_C(0xffffffff));
+                }
             }
         }
-        if (i * s + j < s * m) {
-            cerr << "too less data i = " << dec << i
-                 << " s = " << s << " m = " << m
-                 << endl;
-            return -1;
-        }
-        if (is) {
-            is >> *wafom;
-        }
-        if (is) {
-            is >> *tvalue;
-        }
-        if (n == sizeof(U) * 8) {
-            for (size_t i = 0; i < s * m; i++) {
-                base[i] = static_cast<U>(data[i]);
-            }
-        } else if (n == 32) { // U is uint64_t
-            for (size_t i = 0; i < s * m; i++) {
-                base[i] = data[i] << 32;
-            }
-        } else { // n == 64 U is uint32_t
-            for (size_t i = 0; i < s * m; i++) {
-                base[i] = static_cast<U>((data[i] >> 32)
-                                        & UINT32_C(0xffffffff));
+        *wafom = NAN;
+        *tvalue = -1;
+        double w;
+        if (scanner.next(w)) {
+            *wafom = w;
+            int64_t t;
+            if (scanner.next(t)) {
+                *tvalue = t;
             }
         }
         return 0;
@@ -365,7 +497,6 @@ namespace {
         strsql += "and dimr = ? ";      // 6
         strsql += "and dimf2 >= ?);";   // 7
         sqlite3_stmt* select_sql = NULL;
-        stringstream ssbase;
         r = sqlite3_prepare_v2(db, strsql.c_str(), -1, &select_sql, NULL);
         if (r != SQLITE_OK) {
             cout << "sqlite3_prepare error 1 code = " << dec << r << endl;
@@ -439,10 +570,23 @@ namespace {
             } else {
                 *tvalue = sqlite3_column_int(select_sql, 1);
             }
-            char * tmp = (char *)sqlite3_column_text(select_sql, 2);
-            ssbase << tmp;
+            const char * text
+                = reinterpret_cast<const char *>(
+                    sqlite3_column_text(select_sql, 2));
+            int bytes = sqlite3_column_bytes(select_sql, 2);
+            TextScanner scanner(text, text + bytes);
+            uint64_t tmp;
+            for (size_t i = 0; i < s * m; i++) {
+                if (!scanner.next(tmp)) {
+                    cout << "too less data in database" << endl;
+                    r = -1;
+                    break;
+                }
+                base[i] = static_cast<U>(tmp);
+            }
         } while (false);
         // release sql
+        int data_error = r;
         r = sqlite3_finalize(select_sql);
         if (r != SQLITE_OK) {
             cout << "error finalize r = " << dec << r << endl;
@@ -452,8 +596,8 @@ namespace {
         if (r != SQLITE_OK) {
             return r;
         }
-        for (size_t i = 0; i < s * m; i++) {
-            ssbase >> base[i];
+        if (data_error != SQLITE_ROW) {
+            return data_error;
         }
 #if defined(DEBUG)
         cout << "out select_digital_net_data" << endl;
@@ -610,6 +754,9 @@ namespace MCQMCIntegration {
         default:
             int min = 0;
             int max = 0;
+            if (getEmbeddedSMinMax(id, &min, &max)) {
+                return max;
+            }
             int r = get_s_minmax(path, id, &min, &max);
             if (r < 0) {
                 return r;
@@ -636,6 +783,9 @@ namespace MCQMCIntegration {
         default:
             int min = 0;
             int max = 0;
+            if (getEmbeddedSMinMax(id, &min, &max)) {
+                return min;
+            }
             int r = get_s_minmax(path, id, &min, &max);
             if (r < 0) {
                 return r;
@@ -662,6 +812,9 @@ namespace MCQMCIntegration {
         default:
             int min = 0;
             int max = 0;
+            if (getEmbeddedMMinMax(id, s, &min, &max)) {
+                return max;
+            }
             int r = get_m_minmax(path, id, s, &min, &max);
             if (r < 0) {
                 return r;
@@ -688,6 +841,9 @@ namespace MCQMCIntegration {
         default:
             int min = 0;
             int max = 0;
+            if (getEmbeddedMMinMax(id, s, &min, &max)) {
+                return min;
+            }
             int r = get_m_minmax(path, id, s, &min, &max);
             if (r < 0) {
                 return r;
@@ -706,17 +862,20 @@ namespace MCQMCIntegration {
         }
     }
 
-    int readDigitalNetHeader(std::istream& is, int * n,
+    template<typename S>
+    int readDigitalNetHeader(S& scanner, int * n,
                              uint32_t * s, uint32_t * m)
     {
-        is >> *n;
-        is >> *s;
-        is >> *m;
-        if (is.good()) {
-            return 0;
-        } else {
-            return -1;
+        uint64_t tmp[3];
+        for (int i = 0; i < 3; i++) {
+            if (!scanner.next(tmp[i])) {
+                return -1;
+            }
         }
+        *n = static_cast<int>(tmp[0]);
+        *s = static_cast<uint32_t>(tmp[1]);
+        *m = static_cast<uint32_t>(tmp[2]);
+        return 0;
     }
 
 /**
@@ -734,20 +893,13 @@ namespace MCQMCIntegration {
  * @exception runtime_error, when can't read data from is.
  */
 
-    int readDigitalNetData(std::istream& is, int n,
-                           uint32_t s, uint32_t m,
-                           uint64_t base[],
-                           int64_t * tvalue, double * wafom)
-    {
-        return read_digital_net_data(is, n, s, m, base, tvalue, wafom);
-    }
-
-    int readDigitalNetData(std::istream& is, int n,
+    template<typename S, typename U>
+    int readDigitalNetData(S& scanner, int n,
                            uint32_t s, uint32_t m,
-                           uint32_t base[],
+                           U base[],
                            int64_t * tvalue, double * wafom)
     {
-        return read_digital_net_data(is, n, s, m, base, tvalue, wafom);
+        return read_digital_net_data(scanner, n, s, m, base, tvalue, wafom);
     }
 
 /**
@@ -777,6 +929,9 @@ namespace MCQMCIntegration {
             path = makePath(name, "_Bs53.col");
             return readInterlacedSobolBase(path, s, m, base);
         default:
+            if (selectEmbeddedNet(id, s, m, base, tvalue, wafom)) {
+                return 0;
+            }
             return select_digital_net_data(id, s, m, base, tvalue, wafom);
         }
     }
@@ -798,10 +953,56 @@ namespace MCQMCIntegration {
             path = makePath(name, "_Bs53.col");
             return readInterlacedSobolBase(path, s, m, base);
         default:
+            if (selectEmbeddedNet(id, s, m, base, tvalue, wafom)) {
+                return 0;
+            }
             return select_digital_net_data(id, s, m, base, tvalue, wafom);
         }
     }
 
+    namespace {
+        /*
+         * loader for shared memory cache, Sobol type data do not have
+         * WAFOM and t-value.
+         */
+        int load_base(DigitalNetID id, uint32_t s, uint32_t m,
+                      uint64_t base[], int64_t * tvalue, double * wafom)
+        {
+            *tvalue = -1;
+            *wafom = NAN;
+            return readDigitalNetData(id, s, m, base, tvalue, wafom);
+        }
+    }
+
+    void DigitalNet<uint64_t>::allocateBase(bool clear) {
+        if (clear) {
+            base = new uint64_t[s * m]();
+        } else {
+            base = new uint64_t[s * m];
+        }
+        baseHolder.reset(base, default_delete<uint64_t[]>());
+        baseShared = false;
+    }
+
+    void DigitalNet<uint64_t>::releaseBase() {
+        baseHolder.reset();
+        base = NULL;
+        baseShared = false;
+    }
+
+    /*
+     * make private copy of base matrix before modification, if it is
+     * in shared memory or shared with other nets.
+     */
+    void DigitalNet<uint64_t>::ownBase() {
+        if (!baseShared && baseHolder.use_count() <= 1) {
+            return;
+        }
+        shared_ptr<uint64_t> shared = baseHolder;
+        allocateBase(false);
+        memcpy(base, shared.get(), sizeof(uint64_t) * s * m);
+    }
+
     void DigitalNet<uint64_t>::pointInitialize() {
 #if defined(DEBUG)
         using namespace std;
@@ -830,9 +1031,12 @@ namespace MCQMCIntegration {
         if (point == NULL) {
             point = new double[s]();
         }
-        for (uint32_t i = 0; i < s; ++i) {
+        for (uint32_t i = 0; i < materialized; ++i) {
             point_base[i] = 0;
         }
+        for (uint32_t i = materialized; i < s; ++i) {
+            point[i] = NAN;
+        }
         if (digitalShift) {
             for (uint32_t i = 0; i < s; ++i) {
                 shift[i] = mt();
@@ -869,8 +1073,12 @@ namespace MCQMCIntegration {
         }
         cout << endl;
 #endif
-        for (uint32_t i = 0; i < s; ++i) {
-            point_base[i] ^= getBase(bit, i);
+        if (packed != NULL) {
+            packed->xorRow(bit, point_base, materialized);
+        } else {
+            for (uint32_t i = 0; i < materialized; ++i) {
+                point_base[i] ^= base[bit * s + i];
+            }
         }
         convertPoint();
         if (count == (UINT64_C(1) << m)) {
@@ -890,15 +1098,127 @@ namespace MCQMCIntegration {
 #endif
     }
 
+    void DigitalNet<uint64_t>::setIndex(uint64_t index) {
+        // index th point is sum of rows of bits of gray code of index.
+        uint64_t gray = index ^ (index >> 1);
+        for (uint32_t i = 0; i < materialized; ++i) {
+            point_base[i] = 0;
+        }
+        for (uint32_t k = 0; k < m; k++) {
+            if (((gray >> k) & 1) == 0) {
+                continue;
+            }
+            if (packed != NULL) {
+                packed->xorRow(k, point_base, materialized);
+            } else {
+                for (uint32_t i = 0; i < materialized; ++i) {
+                    point_base[i] ^= base[k * s + i];
+                }
+            }
+        }
+        count = index + 1;
+        grayindex.set(count);
+        convertPoint();
+    }
+
+    void DigitalNet<uint64_t>::setShift(const uint64_t shift[]) {
+        for (uint32_t i = 0; i < s; ++i) {
+            this->shift[i] = shift[i];
+        }
+        convertPoint();
+    }
+
     void DigitalNet<uint64_t>::convertPoint() {
-        for (uint32_t i = 0; i < s; i++) {
+        for (uint32_t i = 0; i < materialized; i++) {
             // shift して1を立てている
             uint64_t tmp = (point_base[i] ^ shift[i]) >> get_max;
             point[i] = static_cast<double>(tmp) * factor + eps;
         }
     }
 
+    void DigitalNet<uint64_t>::materialize(uint32_t d) {
+        uint32_t last = d + lazy_chunk - 1;
+        last = last - last % lazy_chunk;
+        if (last > s) {
+            last = s;
+        }
+        if (last <= materialized) {
+            return;
+        }
+        if (reader == NULL || !reader->read(last, base)) {
+            //throw runtime_error("can't read data!");
+            throw "can't read data!";
+        }
+        // make current point, which is count - 1 th point in gray code
+        // order.
+        uint64_t gray = (count - 1) ^ ((count - 1) >> 1);
+        for (uint32_t i = materialized; i < last; i++) {
+            point_base[i] = 0;
+            for (uint32_t k = 0; k < m; k++) {
+                if ((gray >> k) & 1) {
+                    point_base[i] ^= getBase(k, i);
+                }
+            }
+            uint64_t tmp = (point_base[i] ^ shift[i]) >> get_max;
+            point[i] = static_cast<double>(tmp) * factor + eps;
+        }
+        materialized = last;
+        if (materialized == s) {
+            delete reader;
+            reader = NULL;
+        }
+    }
+
+    uint64_t DigitalNet<uint64_t>::getPackedBase(int i, int j) const {
+        return packed->get(i, j);
+    }
+
+    void DigitalNet<uint64_t>::setCompact(int precision) {
+        if (precision < 1 || precision > 64) {
+            //throw invalid_argument("precision should be 1 .. 64");
+            throw "precision should be 1 .. 64";
+        }
+        requireDimension(s);
+        if (packed != NULL) {
+            allocateBase(false);
+            packed->unpack(base);
+        } else {
+            packed = new PackedBase;
+        }
+        packed->pack(base, s, m, precision);
+        releaseBase();
+    }
+
+    void DigitalNet<uint64_t>::writeCompact(std::ostream& os, int precision) {
+        requireDimension(s);
+        if (packed != NULL && packed->getPrecision() == precision) {
+            packed->write(os, wafom, tvalue);
+            return;
+        }
+        PackedBase tmp;
+        if (packed != NULL) {
+            uint64_t * work = new uint64_t[s * m];
+            packed->unpack(work);
+            tmp.pack(work, s, m, precision);
+            delete[] work;
+        } else {
+            tmp.pack(base, s, m, precision);
+        }
+        tmp.write(os, wafom, tvalue);
+    }
+
     void DigitalNet<uint64_t>::linearScramble() {
+        requireDimension(s);
+        int precision = 0;
+        if (packed != NULL) {
+            precision = packed->getPrecision();
+            allocateBase(false);
+            packed->unpack(base);
+            delete packed;
+            packed = NULL;
+        } else {
+            ownBase();
+        }
         const size_t N = 64;
         uint64_t LowTriMat[N];
         uint64_t tmp;
@@ -918,6 +1238,9 @@ namespace MCQMCIntegration {
                 setBase(k, i, tmp);
             }
         }
+        if (precision > 0) {
+            setCompact(precision);
+        }
     }
 
     DigitalNet<uint64_t>::GrayIndex::GrayIndex() {
@@ -926,6 +1249,9 @@ namespace MCQMCIntegration {
     void DigitalNet<uint64_t>::GrayIndex::clear() {
         count = 1;
     }
+    void DigitalNet<uint64_t>::GrayIndex::set(uint64_t count) {
+        this->count = count;
+    }
     void DigitalNet<uint64_t>::GrayIndex::next() {
         count++;
     }
@@ -949,20 +1275,41 @@ namespace MCQMCIntegration {
  */
     DigitalNet<uint64_t>::DigitalNet(std::istream& is) {
         //using namespace std;
-        int n;
         //id = -100;
-        int r = readDigitalNetHeader(is, &n, &s, &m);
-        if (r != 0) {
-            //throw std::runtime_error("data type mismatch!");
-            throw "data type mismatch!";
-        }
-        base = new uint64_t[s * m]();
-        r = readDigitalNetData(is, n, s, m, base,
-                               &tvalue, &wafom);
-        if (r != 0) {
-            //throw std::runtime_error("data type mismatch!");
-            throw "data type mismatch!";
+        // numbers are taken from stream buffer one by one, and data
+        // after the net are left in the stream.
+        reader = NULL;
+        packed = NULL;
+        base = NULL;
+        baseShared = false;
+        is >> ws;
+        if (is.rdbuf() != NULL && is.rdbuf()->sgetc()
+            == static_cast<int>(DIGITAL_PACKED_MAGIC & 0xff)) {
+            packed = new PackedBase;
+            if (!packed->read(is, &wafom, &tvalue)) {
+                delete packed;
+                //throw std::runtime_error("data type mismatch!");
+                throw "data type mismatch!";
+            }
+            s = packed->getS();
+            m = packed->getM();
+        } else {
+            int n;
+            StreamScanner scanner(is);
+            int r = readDigitalNetHeader(scanner, &n, &s, &m);
+            if (r != 0) {
+                //throw std::runtime_error("data type mismatch!");
+                throw "data type mismatch!";
+            }
+            allocateBase(true);
+            r = readDigitalNetData(scanner, n, s, m, base,
+                                   &tvalue, &wafom);
+            if (r != 0) {
+                //throw std::runtime_error("data type mismatch!");
+                throw "data type mismatch!";
+            }
         }
+        materialized = s;
         shift = NULL;
         point_base = NULL;
         point = NULL;
@@ -982,18 +1329,82 @@ namespace MCQMCIntegration {
  * @exception runtime_error, when can't read data from is.
  */
     DigitalNet<uint64_t>::DigitalNet(DigitalNetID id,
-                                     uint32_t s, uint32_t m)
+                                     uint32_t s, uint32_t m, bool lazy)
     {
         this->s = s;
         this->m = m;
         //this->id = static_cast<int>(id);
-        base = new uint64_t[s * m]();
-        int r = readDigitalNetData(id, s, m, base,
-                                   &tvalue, &wafom);
+        reader = NULL;
+        packed = NULL;
+        base = NULL;
+        baseShared = false;
+        if (lazy && !(id == SOBOL && isEmbeddedSobol(s, m))) {
+            reader = openColumnReader(id, s, m);
+        }
+        int r = shared_base_unavailable;
+        if (reader != NULL) {
+            // not initialized, pages of columns not made are not touched.
+            allocateBase(false);
+            materialized = 0;
+            wafom = NAN;
+            tvalue = -1;
+            r = 0;
+        } else if (getSharedMemoryCache()) {
+            r = get_shared_base(id, s, m, load_base, &baseHolder,
+                                &tvalue, &wafom);
+            if (r == 0) {
+                base = baseHolder.get();
+                baseShared = true;
+            }
+        }
+        if (r == shared_base_unavailable) {
+            // shared memory is not used or not available
+            allocateBase(true);
+            r = load_base(id, s, m, base, &tvalue, &wafom);
+        }
         if (r != 0) {
+            delete reader;
             //throw runtime_error("data type mismatch!");
             throw "data type mismatch!";
         }
+        if (reader == NULL) {
+            materialized = s;
+        }
+        shift = NULL;
+        point_base = NULL;
+        point = NULL;
+        count = 0;
+        digitalShift = false;
+        pointInitialize();
+        if (materialized == 0) {
+            requireDimension(1);
+        }
+    }
+
+    DigitalNet<uint64_t>::DigitalNet(
+        const std::shared_ptr<const DigitalNet<uint64_t> >& prototype)
+    {
+        const DigitalNet<uint64_t>& that = *prototype;
+        if (that.reader != NULL) {
+            //throw runtime_error("can't share lazy net!");
+            throw "can't share lazy net!";
+        }
+        s = that.s;
+        m = that.m;
+        wafom = that.wafom;
+        tvalue = that.tvalue;
+        reader = NULL;
+        packed = NULL;
+        base = NULL;
+        baseShared = false;
+        if (that.packed != NULL) {
+            packed = new PackedBase(*that.packed);
+        } else {
+            baseHolder = that.baseHolder;
+            base = that.base;
+            baseShared = that.baseShared;
+        }
+        materialized = s;
         shift = NULL;
         point_base = NULL;
         point = NULL;
@@ -1004,10 +1415,12 @@ namespace MCQMCIntegration {
 
     DigitalNet<uint64_t>::~DigitalNet()
     {
+        delete reader;
+        delete packed;
 #if defined(DEBUG)
         cout << "DigitalNet DEBUG: before delete[] base" << endl;
 #endif
-        delete[] base;
+        releaseBase();
         delete[] shift;
         if (point_base != NULL) {
 #if defined(DEBUG)
@@ -1028,6 +1441,7 @@ namespace MCQMCIntegration {
 
     void DigitalNet<uint64_t>::showStatus(std::ostream& os)
     {
+        requireDimension(s);
         os << "n = " << N << endl;
         os << "s = " << s << endl;
         os << "m = " << m << endl;
@@ -1048,6 +1462,128 @@ namespace MCQMCIntegration {
         mt.seed(seed);
     }
 
+    /*
+     * FNV-1a hash of made part of base matrix.
+     */
+    uint64_t DigitalNet<uint64_t>::fingerprint() const
+    {
+        uint64_t hash = UINT64_C(0xcbf29ce484222325);
+        for (uint32_t k = 0; k < m; k++) {
+            for (uint32_t i = 0; i < materialized; i++) {
+                uint64_t x = getBase(k, i);
+                for (int b = 0; b < 64; b += 8) {
+                    hash ^= (x >> b) & 0xff;
+                    hash *= UINT64_C(0x100000001b3);
+                }
+            }
+        }
+        return hash;
+    }
+
+    void DigitalNet<uint64_t>::saveState(std::ostream& os) const
+    {
+        if (shift == NULL) {
+            //throw runtime_error("point is not initialized!");
+            throw "point is not initialized!";
+        }
+        write_le64(os, state_magic);
+        write_le64(os, s);
+        write_le64(os, m);
+        write_le64(os, materialized);
+        write_le64(os, fingerprint());
+        write_le64(os, count);
+        write_le64(os, digitalShift ? 1 : 0);
+        for (uint32_t i = 0; i < s; ++i) {
+            write_le64(os, shift[i]);
+        }
+        for (uint32_t i = 0; i < materialized; ++i) {
+            write_le64(os, point_base[i]);
+        }
+        // text form is the only portable form of std::mt19937_64
+        ostringstream text;
+        text << mt;
+        string str = text.str();
+        write_le64(os, str.size());
+        os.write(str.data(), str.size());
+    }
+
+    bool DigitalNet<uint64_t>::restoreState(std::istream& is)
+    {
+        uint64_t magic;
+        uint64_t ss;
+        uint64_t mm;
+        uint64_t made;
+        uint64_t hash;
+        uint64_t cnt;
+        uint64_t shifted;
+        if (!read_le64(is, &magic) || magic != state_magic
+            || !read_le64(is, &ss) || ss != s
+            || !read_le64(is, &mm) || mm != m
+            || !read_le64(is, &made) || made > s
+            || !read_le64(is, &hash)
+            || !read_le64(is, &cnt) || cnt > (UINT64_C(1) << m)
+            || !read_le64(is, &shifted)) {
+            return false;
+        }
+        vector<uint64_t> sh(s);
+        for (uint32_t i = 0; i < s; ++i) {
+            if (!read_le64(is, &sh[i])) {
+                return false;
+            }
+        }
+        vector<uint64_t> pb(made);
+        for (uint64_t i = 0; i < made; ++i) {
+            if (!read_le64(is, &pb[i])) {
+                return false;
+            }
+        }
+        uint64_t size;
+        if (!read_le64(is, &size) || size > 100000) {
+            return false;
+        }
+        string str(size, '\0');
+        is.read(&str[0], size);
+        if (!is) {
+            return false;
+        }
+        std::mt19937_64 saved;
+        istringstream text(str);
+        text >> saved;
+        if (text.fail()) {
+            return false;
+        }
+        if (shift == NULL) {
+            // allocate without consuming random numbers
+            bool ds = digitalShift;
+            digitalShift = false;
+            pointInitialize();
+            digitalShift = ds;
+        }
+        if (made > materialized) {
+            materialize(static_cast<uint32_t>(made));
+        }
+        if (made != materialized || hash != fingerprint()) {
+            return false;
+        }
+        for (uint32_t i = 0; i < s; ++i) {
+            shift[i] = sh[i];
+        }
+        for (uint32_t i = 0; i < materialized; ++i) {
+            point_base[i] = pb[i];
+        }
+        mt = saved;
+        digitalShift = shifted != 0;
+        count = cnt;
+        // nextPoint() clears gray index when count goes back to 0
+        if (count == 0) {
+            grayindex.clear();
+        } else {
+            grayindex.set(count);
+        }
+        convertPoint();
+        return true;
+    }
+
 #if 0
     const char * DigitalNet<uint64_t>::getDataPath()
     {
@@ -0,0 +1,134 @@
+/**
+ * @file DigitalNetLoader.cpp
+ *
+ * @brief Asynchronous loading of pre-defined Digital Nets.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/DigitalNetLoader.h>
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    DigitalNetPtr load(DigitalNetID id, uint32_t s, uint32_t m, bool lazy)
+    {
+        return DigitalNetPtr(new DigitalNet<uint64_t>(id, s, m, lazy));
+    }
+}
+
+namespace MCQMCIntegration {
+
+    std::future<DigitalNetPtr> loadDigitalNetAsync(DigitalNetID id,
+                                                   uint32_t s,
+                                                   uint32_t m,
+                                                   bool lazy)
+    {
+        return async(launch::async, load, id, s, m, lazy);
+    }
+
+    DigitalNetWarmup::DigitalNetWarmup(const vector<DigitalNetConfig>& configs,
+                                       unsigned threads)
+        : configs(configs), nets(configs.size()), errors(configs.size()),
+          done(configs.size(), false), taken(configs.size(), false)
+    {
+        nextConfig = 0;
+        takenCount = 0;
+        if (threads == 0) {
+            threads = thread::hardware_concurrency();
+            if (threads == 0) {
+                threads = 1;
+            }
+        }
+        if (threads > configs.size()) {
+            threads = configs.size();
+        }
+        for (unsigned i = 0; i < threads; i++) {
+            this->threads.push_back(thread(&DigitalNetWarmup::work, this));
+        }
+    }
+
+    DigitalNetWarmup::~DigitalNetWarmup()
+    {
+        {
+            unique_lock<mutex> lock(mtx);
+            // skip configurations not started yet
+            nextConfig = configs.size();
+        }
+        for (size_t i = 0; i < threads.size(); i++) {
+            threads[i].join();
+        }
+    }
+
+    void DigitalNetWarmup::work()
+    {
+        for (;;) {
+            size_t index;
+            {
+                unique_lock<mutex> lock(mtx);
+                if (nextConfig >= configs.size()) {
+                    return;
+                }
+                index = nextConfig++;
+            }
+            const DigitalNetConfig& c = configs[index];
+            DigitalNetPtr net;
+            exception_ptr error;
+            try {
+                net = load(c.id, c.s, c.m, false);
+            } catch (...) {
+                error = current_exception();
+            }
+            unique_lock<mutex> lock(mtx);
+            nets[index] = net;
+            errors[index] = error;
+            done[index] = true;
+            cond.notify_all();
+        }
+    }
+
+    bool DigitalNetWarmup::next(size_t * index, DigitalNetPtr * net)
+    {
+        unique_lock<mutex> lock(mtx);
+        if (takenCount >= configs.size()) {
+            return false;
+        }
+        for (;;) {
+            for (size_t i = 0; i < configs.size(); i++) {
+                if (done[i] && !taken[i]) {
+                    taken[i] = true;
+                    takenCount++;
+                    if (errors[i]) {
+                        rethrow_exception(errors[i]);
+                    }
+                    *index = i;
+                    *net = nets[i];
+                    return true;
+                }
+            }
+            cond.wait(lock);
+        }
+    }
+
+    DigitalNetPtr DigitalNetWarmup::get(size_t index)
+    {
+        unique_lock<mutex> lock(mtx);
+        while (!done[index]) {
+            cond.wait(lock);
+        }
+        if (errors[index]) {
+            rethrow_exception(errors[index]);
+        }
+        return nets[index];
+    }
+}
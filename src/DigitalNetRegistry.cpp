@@ -0,0 +1,147 @@
+/**
+ * @file DigitalNetRegistry.cpp
+ *
+ * @brief Process-wide registry of constructed Digital Nets.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/DigitalNetRegistry.h>
+
+using namespace std;
+
+namespace MCQMCIntegration {
+
+    bool DigitalNetRegistry::Key::operator<(const Key& that) const
+    {
+        if (id != that.id) {
+            return id < that.id;
+        }
+        if (bitsize != that.bitsize) {
+            return bitsize < that.bitsize;
+        }
+        if (s != that.s) {
+            return s < that.s;
+        }
+        if (m != that.m) {
+            return m < that.m;
+        }
+        if (scramble != that.scramble) {
+            return scramble < that.scramble;
+        }
+        return seed < that.seed;
+    }
+
+    DigitalNetRegistry::DigitalNetRegistry(size_t capacity)
+    {
+        this->capacity = capacity;
+        hits = 0;
+        misses = 0;
+    }
+
+    DigitalNetRegistry& DigitalNetRegistry::getInstance()
+    {
+        static DigitalNetRegistry instance;
+        return instance;
+    }
+
+    SharedDigitalNet DigitalNetRegistry::get(DigitalNetID id,
+                                             uint32_t s, uint32_t m,
+                                             bool scramble, uint64_t seed)
+    {
+        Key key;
+        key.id = static_cast<int>(id);
+        key.bitsize = 64;
+        key.s = s;
+        key.m = m;
+        key.scramble = scramble;
+        key.seed = scramble ? seed : 0;
+        {
+            unique_lock<mutex> lock(mtx);
+            map<Key, Entry>::iterator it = entries.find(key);
+            if (it != entries.end()) {
+                hits++;
+                lru.splice(lru.begin(), lru, it->second.pos);
+                return it->second.net;
+            }
+            misses++;
+        }
+        // construct without lock, other nets can be got meanwhile.
+        shared_ptr<DigitalNet<uint64_t> > net(
+            new DigitalNet<uint64_t>(id, s, m));
+        if (scramble) {
+            net->setSeed(seed);
+            net->linearScramble();
+        }
+        unique_lock<mutex> lock(mtx);
+        map<Key, Entry>::iterator it = entries.find(key);
+        if (it != entries.end()) {
+            // constructed by other thread
+            lru.splice(lru.begin(), lru, it->second.pos);
+            return it->second.net;
+        }
+        if (capacity == 0) {
+            return net;
+        }
+        lru.push_front(key);
+        Entry& entry = entries[key];
+        entry.net = net;
+        entry.pos = lru.begin();
+        evict();
+        return net;
+    }
+
+    void DigitalNetRegistry::evict()
+    {
+        while (entries.size() > capacity) {
+            entries.erase(lru.back());
+            lru.pop_back();
+        }
+    }
+
+    void DigitalNetRegistry::setCapacity(size_t capacity)
+    {
+        unique_lock<mutex> lock(mtx);
+        this->capacity = capacity;
+        evict();
+    }
+
+    void DigitalNetRegistry::clear()
+    {
+        unique_lock<mutex> lock(mtx);
+        entries.clear();
+        lru.clear();
+    }
+
+    size_t DigitalNetRegistry::getCapacity()
+    {
+        unique_lock<mutex> lock(mtx);
+        return capacity;
+    }
+
+    size_t DigitalNetRegistry::size()
+    {
+        unique_lock<mutex> lock(mtx);
+        return entries.size();
+    }
+
+    uint64_t DigitalNetRegistry::getHits()
+    {
+        unique_lock<mutex> lock(mtx);
+        return hits;
+    }
+
+    uint64_t DigitalNetRegistry::getMisses()
+    {
+        unique_lock<mutex> lock(mtx);
+        return misses;
+    }
+}
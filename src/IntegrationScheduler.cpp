@@ -0,0 +1,252 @@
+/**
+ * @file IntegrationScheduler.cpp
+ *
+ * @brief Asynchronous Quasi Monte-Carlo integration jobs on thread pool.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/IntegrationScheduler.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace MCQMCIntegration {
+
+    struct IntegrationScheduler::Job {
+        Job(const IntegrationConfig& config) : config(config) {
+        }
+        JobID id;
+        uint64_t sequence;
+        IntegrationConfig config;
+        Runner runner;
+        // set by cancel() of running job, NULL for submitRunner()
+        StopFlag stop;
+        promise<MCQMCResult> result;
+    };
+
+    bool IntegrationScheduler::JobOrder::operator()(const JobPtr& a,
+                                                    const JobPtr& b) const
+    {
+        if (a->config.priority != b->config.priority) {
+            return a->config.priority > b->config.priority;
+        }
+        return a->sequence < b->sequence;
+    }
+
+    bool IntegrationScheduler::NetKey::operator<(const NetKey& that) const
+    {
+        if (id != that.id) {
+            return id < that.id;
+        }
+        if (s != that.s) {
+            return s < that.s;
+        }
+        return m < that.m;
+    }
+
+    IntegrationScheduler::IntegrationScheduler(ThreadPool& pool,
+                                               size_t maxBatch)
+        : pool(pool)
+    {
+        this->maxBatch = maxBatch == 0 ? 1 : maxBatch;
+        nextId = 1;
+        sequence = 0;
+        running = 0;
+        outstanding = 0;
+    }
+
+    IntegrationScheduler::~IntegrationScheduler()
+    {
+        vector<JobPtr> jobs;
+        {
+            unique_lock<mutex> lock(mtx);
+            jobs.assign(queue.begin(), queue.end());
+            queue.clear();
+            byNet.clear();
+            byId.clear();
+        }
+        for (size_t i = 0; i < jobs.size(); i++) {
+            jobs[i]->result.set_exception(
+                make_exception_ptr(runtime_error("job is cancelled")));
+        }
+        // posted tasks refer this
+        unique_lock<mutex> lock(mtx);
+        while (outstanding > 0) {
+            idleCond.wait(lock);
+        }
+    }
+
+    future<MCQMCResult>
+    IntegrationScheduler::submitRunner(const Runner& runner,
+                                       const IntegrationConfig& config,
+                                       JobID * id)
+    {
+        return submitJob(runner, config, id, StopFlag());
+    }
+
+    future<MCQMCResult>
+    IntegrationScheduler::submitJob(const Runner& runner,
+                                    const IntegrationConfig& config,
+                                    JobID * id,
+                                    const StopFlag& stop)
+    {
+        JobPtr job(new Job(config));
+        job->runner = runner;
+        job->stop = stop;
+        future<MCQMCResult> f = job->result.get_future();
+        {
+            unique_lock<mutex> lock(mtx);
+            job->id = nextId++;
+            job->sequence = sequence++;
+            NetKey key = {config.id, config.s, config.m};
+            queue.insert(job);
+            byNet[key].insert(job);
+            byId[job->id] = job;
+            outstanding++;
+        }
+        if (id != NULL) {
+            *id = job->id;
+        }
+        // one task for each job, a task may run several jobs and others
+        // find no job.
+        pool.post([this](unsigned) { drain(); });
+        return f;
+    }
+
+    /*
+     * remove waiting job from indexes, mtx should be locked.
+     */
+    void IntegrationScheduler::remove(const JobPtr& job)
+    {
+        NetKey key = {job->config.id, job->config.s, job->config.m};
+        queue.erase(job);
+        map<NetKey, JobQueue>::iterator it = byNet.find(key);
+        if (it != byNet.end()) {
+            it->second.erase(job);
+            if (it->second.empty()) {
+                byNet.erase(it);
+            }
+        }
+        byId.erase(job->id);
+    }
+
+    bool IntegrationScheduler::cancel(JobID id)
+    {
+        JobPtr job;
+        {
+            unique_lock<mutex> lock(mtx);
+            map<JobID, JobPtr>::iterator it = byId.find(id);
+            if (it == byId.end()) {
+                it = runningById.find(id);
+                if (it == runningById.end() || !it->second->stop) {
+                    return false;
+                }
+                *it->second->stop = true;
+                return true;
+            }
+            job = it->second;
+            remove(job);
+            if (queue.empty() && running == 0) {
+                idleCond.notify_all();
+            }
+        }
+        job->result.set_exception(
+            make_exception_ptr(runtime_error("job is cancelled")));
+        return true;
+    }
+
+    size_t IntegrationScheduler::pending()
+    {
+        unique_lock<mutex> lock(mtx);
+        return queue.size();
+    }
+
+    void IntegrationScheduler::wait()
+    {
+        unique_lock<mutex> lock(mtx);
+        while (!queue.empty() || running > 0) {
+            idleCond.wait(lock);
+        }
+    }
+
+    /*
+     * run jobs one by one, the next job is the job of the highest
+     * priority at that time, and the cursor is kept while the job is of
+     * the same net. Other workers take jobs of the same net in parallel.
+     */
+    void IntegrationScheduler::drain()
+    {
+        unique_ptr<DigitalNet<uint64_t> > cursor;
+        exception_ptr error;
+        NetKey key = {SOBOL, 0, 0};
+        size_t count = 0;
+        for (;;) {
+            JobPtr job;
+            {
+                unique_lock<mutex> lock(mtx);
+                if (count > 0) {
+                    // previous job
+                    running--;
+                    idleCond.notify_all();
+                }
+                if (!queue.empty() && count < maxBatch) {
+                    JobPtr top = *queue.begin();
+                    NetKey topKey = {top->config.id, top->config.s,
+                                     top->config.m};
+                    if (count == 0 || !(topKey < key || key < topKey)) {
+                        job = top;
+                        key = topKey;
+                        remove(job);
+                        runningById[job->id] = job;
+                        running++;
+                    }
+                }
+                if (!job) {
+                    outstanding--;
+                    idleCond.notify_all();
+                    return;
+                }
+            }
+            if (count == 0) {
+                try {
+                    cursor.reset(new DigitalNet<uint64_t>(
+                                     DigitalNetRegistry::getInstance()
+                                     .get(key.id, key.s, key.m)));
+                } catch (...) {
+                    error = current_exception();
+                }
+            }
+            count++;
+            MCQMCResult result;
+            exception_ptr failed = error;
+            if (!failed) {
+                try {
+                    cursor->setSeed(job->config.seed);
+                    result = job->runner(*cursor);
+                } catch (...) {
+                    failed = current_exception();
+                }
+            }
+            {
+                // cancel() after the result is ready returns false
+                unique_lock<mutex> lock(mtx);
+                runningById.erase(job->id);
+            }
+            if (failed) {
+                job->result.set_exception(failed);
+            } else {
+                job->result.set_value(result);
+            }
+        }
+    }
+}
@@ -16,11 +16,15 @@
  */
 #include <MCQMCIntegration/MCQMCIntegration.h>
 #include <math.h> // for INFINITY
+#include "byte_order.h"
 #include <stdexcept>
+#include <cstring>
 
 using namespace std;
 
 namespace {
+    using namespace MCQMCIntegration;
+
     const double tval95[100] = {
         INFINITY,
         12.70620473617471,
@@ -468,6 +472,57 @@ namespace {
             return array[99];
         }
     }
+
+    /*
+     * degree of freedom for tvalue(), which uses the last entry of
+     * tables for df > 99.
+     */
+    int table_df(int64_t df)
+    {
+        if (df > 99) {
+            return 99;
+        }
+        return static_cast<int>(df);
+    }
+
+    // "OVAR" and version 1
+    const uint64_t variance_magic = UINT64_C(0x000000015241564f);
+    // "BVAR" and version 1
+    const uint64_t block_variance_magic = UINT64_C(0x0000000152415642);
+
+    /*
+     * sum of data[0] .. data[size - 1] - center, and sum of their
+     * squares, in independent lanes.
+     */
+    template<int lanes>
+    void lane_sum(const double data[], int size, double center,
+                  double * sum, double * sum2)
+    {
+        double s[lanes] = {0};
+        double s2[lanes] = {0};
+        int i = 0;
+        for (; i + lanes <= size; i += lanes) {
+            for (int j = 0; j < lanes; j++) {
+                double d = data[i + j] - center;
+                s[j] += d;
+                s2[j] += d * d;
+            }
+        }
+        for (int j = 0; i < size; i++, j++) {
+            double d = data[i] - center;
+            s[j] += d;
+            s2[j] += d * d;
+        }
+        // pairwise
+        for (int w = lanes / 2; w > 0; w /= 2) {
+            for (int j = 0; j < w; j++) {
+                s[j] += s[j + w];
+                s2[j] += s2[j + w];
+            }
+        }
+        *sum = s[0];
+        *sum2 = s2[0];
+    }
 }
 
 namespace MCQMCIntegration {
@@ -505,11 +560,232 @@ namespace MCQMCIntegration {
 
     double OnlineVariance::absErr(const int prob) const
     {
-        return tvalue(prob, df) * sqrt(unbiasedVar() / static_cast<double>(n));
+        return tvalue(prob, table_df(df))
+            * sqrt(unbiasedVar() / static_cast<double>(n));
     }
 
     double OnlineVariance::relErr(const int prob) const
     {
         return absErr(prob) / mean;
     }
+
+    const size_t OnlineVariance::serialized_size;
+
+    void OnlineVariance::merge(const OnlineVariance& that)
+    {
+        if (that.n == 0) {
+            return;
+        }
+        if (n == 0) {
+            *this = that;
+            return;
+        }
+        double na = static_cast<double>(n);
+        double nb = static_cast<double>(that.n);
+        double total = na + nb;
+        double delta = that.mean - mean;
+        n += that.n;
+        df = n - 1;
+        mean += delta * (nb / total);
+        M2 += that.M2 + delta * delta * (na * nb / total);
+    }
+
+    void OnlineVariance::serialize(uint8_t buffer[]) const
+    {
+        put_le64(buffer, variance_magic);
+        put_le64(buffer + 8, static_cast<uint64_t>(n));
+        put_le64(buffer + 16, double_bits(mean));
+        put_le64(buffer + 24, double_bits(M2));
+    }
+
+    bool OnlineVariance::deserialize(const uint8_t buffer[], size_t size)
+    {
+        if (size < serialized_size || get_le64(buffer) != variance_magic) {
+            return false;
+        }
+        int64_t count = static_cast<int64_t>(get_le64(buffer + 8));
+        if (count < 0) {
+            return false;
+        }
+        n = count;
+        df = n - 1;
+        mean = bits_double(get_le64(buffer + 16));
+        M2 = bits_double(get_le64(buffer + 24));
+        return true;
+    }
+
+    BlockVariance::BlockVariance()
+    {
+        n = 0;
+        mean = 0.0;
+        M2 = 0.0;
+        used = 0;
+    }
+
+    /*
+     * merge statistics of data in the buffer into count, mean and M2.
+     */
+    void BlockVariance::merged(int64_t * count, double * mean,
+                               double * M2) const
+    {
+        *count = n;
+        *mean = this->mean;
+        *M2 = this->M2;
+        if (used == 0) {
+            return;
+        }
+        // shift by first data, to keep M2 accurate
+        double center = buffer[0];
+        double sum;
+        double sum2;
+        lane_sum<lanes>(buffer, used, center, &sum, &sum2);
+        double nb = used;
+        double d = sum / nb;
+        double bmean = center + d;
+        double bM2 = sum2 - sum * d;
+        if (bM2 < 0) {
+            bM2 = 0;
+        }
+        if (n == 0) {
+            *count = used;
+            *mean = bmean;
+            *M2 = bM2;
+            return;
+        }
+        double na = static_cast<double>(n);
+        double total = na + nb;
+        double delta = bmean - *mean;
+        *count = n + used;
+        *mean += delta * (nb / total);
+        *M2 += bM2 + delta * delta * (na * nb / total);
+    }
+
+    void BlockVariance::addBlock()
+    {
+        merged(&n, &mean, &M2);
+        used = 0;
+    }
+
+    double BlockVariance::getMean() const
+    {
+        int64_t count;
+        double mean;
+        double M2;
+        merged(&count, &mean, &M2);
+        return mean;
+    }
+
+    double BlockVariance::unbiasedVar() const
+    {
+        int64_t count;
+        double mean;
+        double M2;
+        merged(&count, &mean, &M2);
+        return M2 / static_cast<double>(count - 1);
+    }
+
+    double BlockVariance::var() const
+    {
+        int64_t count = getN();
+        if (count == 1) {
+            return 0.0;
+        }
+        return (1.0 - 1.0 / static_cast<double>(count)) * unbiasedVar();
+    }
+
+    double BlockVariance::absErr(const int prob) const
+    {
+        int64_t count = getN();
+        return tvalue(prob, table_df(count - 1))
+            * sqrt(unbiasedVar() / static_cast<double>(count));
+    }
+
+    double BlockVariance::relErr(const int prob) const
+    {
+        return absErr(prob) / getMean();
+    }
+
+    ProgressTracker::ProgressTracker(const ProgressObserver& observer,
+                                     int probability)
+        : observer(observer)
+    {
+        this->probability = probability;
+        points = 0;
+        nextReport = observer.intervalPoints > 0
+            ? observer.intervalPoints : UINT64_MAX;
+        start = chrono::steady_clock::now();
+        progress.value = NAN;
+        progress.error = NAN;
+        progress.trials = 0;
+        progress.points = 0;
+        progress.seconds = 0;
+        progress.throughput = 0;
+    }
+
+    bool ProgressTracker::report(const OnlineVariance& eachintval,
+                                 const BlockVariance& intsum)
+    {
+        if (observer.intervalPoints > 0) {
+            nextReport = points + observer.intervalPoints;
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        progress.trials = static_cast<uint32_t>(eachintval.getN());
+        progress.points = points;
+        progress.seconds = elapsed.count();
+        progress.throughput = progress.seconds > 0
+            ? points / progress.seconds : 0;
+        if (eachintval.getN() > 1) {
+            progress.value = eachintval.getMean();
+            progress.error = eachintval.absErr(probability);
+        } else if (eachintval.getN() == 1) {
+            progress.value = eachintval.getMean();
+            progress.error = NAN;
+        } else if (intsum.getN() > 1) {
+            progress.value = intsum.getMean();
+            progress.error = intsum.absErr(probability);
+        } else {
+            progress.value = intsum.getN() == 1 ? intsum.getMean() : NAN;
+            progress.error = NAN;
+        }
+        if (!observer.callback) {
+            return true;
+        }
+        return observer.callback(progress);
+    }
+
+    const size_t BlockVariance::serialized_size;
+
+    void BlockVariance::serialize(uint8_t buffer[]) const
+    {
+        put_le64(buffer, block_variance_magic);
+        put_le64(buffer + 8, static_cast<uint64_t>(n));
+        put_le64(buffer + 16, double_bits(mean));
+        put_le64(buffer + 24, double_bits(M2));
+        put_le64(buffer + 32, static_cast<uint64_t>(used));
+        for (int i = 0; i < block_size; i++) {
+            uint64_t x = i < used ? double_bits(this->buffer[i]) : 0;
+            put_le64(buffer + 40 + i * 8, x);
+        }
+    }
+
+    bool BlockVariance::deserialize(const uint8_t buffer[], size_t size)
+    {
+        if (size < serialized_size
+            || get_le64(buffer) != block_variance_magic) {
+            return false;
+        }
+        int64_t count = static_cast<int64_t>(get_le64(buffer + 8));
+        uint64_t u = get_le64(buffer + 32);
+        if (count < 0 || u >= static_cast<uint64_t>(block_size)) {
+            return false;
+        }
+        n = count;
+        mean = bits_double(get_le64(buffer + 16));
+        M2 = bits_double(get_le64(buffer + 24));
+        used = static_cast<int>(u);
+        for (int i = 0; i < used; i++) {
+            this->buffer[i] = bits_double(get_le64(buffer + 40 + i * 8));
+        }
+        return true;
+    }
 }
@@ -0,0 +1,114 @@
+/**
+ * @file MTBlockRandom.cpp
+ *
+ * @brief MT19937-64 generating random numbers block by block.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/MTBlockRandom.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+    const int N = MCQMCIntegration::MersenneTwister64::state_size;
+    const int M = MCQMCIntegration::MersenneTwister64::shift_size;
+    const uint64_t upper_mask = UINT64_C(0xFFFFFFFF80000000);
+    const uint64_t lower_mask = UINT64_C(0x7FFFFFFF);
+    const uint64_t matrix_a = UINT64_C(0xB5026F5AA96619E9);
+    const double factor = 1.0 / 9007199254740992.0; // 2^-53
+
+    inline uint64_t twist(uint64_t u, uint64_t l, uint64_t m)
+    {
+        uint64_t y = (u & upper_mask) | (l & lower_mask);
+        // -(y & 1) is all one if the lowest bit is set
+        return m ^ (y >> 1) ^ ((0 - (y & 1)) & matrix_a);
+    }
+}
+
+namespace MCQMCIntegration {
+
+    MTBlockRandom::MTBlockRandom(uint64_t seed)
+    {
+        this->seed(seed);
+    }
+
+    MTBlockRandom::MTBlockRandom(const MersenneTwister64& rand)
+    {
+        // the oldest word is updated first, as generate() does.
+        rand.getState(state);
+        pos = size;
+    }
+
+    void MTBlockRandom::seed(uint64_t seed)
+    {
+        MersenneTwister64 mt(seed);
+        mt.getState(state);
+        pos = size;
+    }
+
+    /*
+     * update whole state and temper all words.
+     */
+    void MTBlockRandom::generate()
+    {
+        int i;
+        for (i = 0; i < N - M; i++) {
+            state[i] = twist(state[i], state[i + 1], state[i + M]);
+        }
+        for (; i < N - 1; i++) {
+            state[i] = twist(state[i], state[i + 1], state[i + M - N]);
+        }
+        state[N - 1] = twist(state[N - 1], state[0], state[M - 1]);
+        for (i = 0; i < N; i++) {
+            uint64_t x = state[i];
+            x ^= (x >> 29) & UINT64_C(0x5555555555555555);
+            x ^= (x << 17) & UINT64_C(0x71D67FFFEDA60000);
+            x ^= (x << 37) & UINT64_C(0xFFF7EEE000000000);
+            x ^= (x >> 43);
+            out[i] = x;
+        }
+        pos = 0;
+    }
+
+    void MTBlockRandom::fill(uint64_t array[], size_t n)
+    {
+        while (n > 0) {
+            if (pos == size) {
+                generate();
+            }
+            size_t len = std::min(n, static_cast<size_t>(size - pos));
+            memcpy(array, out + pos, len * sizeof(uint64_t));
+            pos += static_cast<int>(len);
+            array += len;
+            n -= len;
+        }
+    }
+
+    void MTBlockRandom::fill(double array[], size_t n)
+    {
+        while (n > 0) {
+            if (pos == size) {
+                generate();
+            }
+            size_t len = std::min(n, static_cast<size_t>(size - pos));
+            const uint64_t * p = out + pos;
+            for (size_t i = 0; i < len; i++) {
+                array[i] = static_cast<double>(p[i] >> 11) * factor;
+            }
+            pos += static_cast<int>(len);
+            array += len;
+            n -= len;
+        }
+    }
+}
@@ -0,0 +1,314 @@
+/**
+ * @file MersenneTwister64.cpp
+ *
+ * @brief 64-bit Mersenne Twister with jump ahead.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/MersenneTwister64.h>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    typedef vector<uint64_t> poly_t;
+
+    // degree of characteristic polynomial, Mersenne exponent
+    const int mexp = 19937;
+    const int poly_words = mexp / 64 + 1;
+
+    bool get_bit(const poly_t& p, int i)
+    {
+        return (p[i / 64] >> (i % 64)) & 1;
+    }
+
+    void set_bit(poly_t& p, int i)
+    {
+        p[i / 64] |= UINT64_C(1) << (i % 64);
+    }
+
+    /*
+     * 64 bits of p from i th bit.
+     */
+    uint64_t get_word(const poly_t& p, size_t i)
+    {
+        size_t w = i / 64;
+        int b = i % 64;
+        uint64_t x = p[w] >> b;
+        if (b != 0 && w + 1 < p.size()) {
+            x |= p[w + 1] << (64 - b);
+        }
+        return x;
+    }
+
+    /*
+     * p ^= q * x^shift, for first words of q.
+     */
+    void xor_shifted(poly_t& p, const poly_t& q, size_t words, size_t shift)
+    {
+        size_t w = shift / 64;
+        int b = shift % 64;
+        for (size_t i = 0; i < words && i + w < p.size(); i++) {
+            p[i + w] ^= q[i] << b;
+            if (b != 0 && i + w + 1 < p.size()) {
+                p[i + w + 1] ^= q[i] >> (64 - b);
+            }
+        }
+    }
+
+    int parity(uint64_t x)
+    {
+        x ^= x >> 32;
+        x ^= x >> 16;
+        x ^= x >> 8;
+        x ^= x >> 4;
+        x ^= x >> 2;
+        x ^= x >> 1;
+        return static_cast<int>(x & 1);
+    }
+
+    /*
+     * minimal polynomial of LSB of outputs by Berlekamp-Massey algorithm,
+     * which is the characteristic polynomial of MT19937-64, as it is
+     * irreducible.
+     */
+    poly_t characteristic_polynomial()
+    {
+        const size_t size = 2 * mexp;
+        const size_t words = size / 64 + 2;
+        MersenneTwister64 mt;
+        // sequence in reverse order, s[n - i] is i th bit from size - 1 - n
+        poly_t rev(words, 0);
+        for (size_t n = 0; n < size; n++) {
+            if (mt() & 1) {
+                set_bit(rev, static_cast<int>(size - 1 - n));
+            }
+        }
+        poly_t c(words, 0);
+        poly_t b(words, 0);
+        c[0] = 1;
+        b[0] = 1;
+        size_t len = 0;
+        size_t m = 1;
+        for (size_t n = 0; n < size; n++) {
+            size_t used = len / 64 + 1;
+            size_t offset = size - 1 - n;
+            uint64_t d = 0;
+            for (size_t w = 0; w < used; w++) {
+                d ^= c[w] & get_word(rev, offset + w * 64);
+            }
+            if (parity(d) == 0) {
+                m++;
+            } else if (2 * len <= n) {
+                poly_t t = c;
+                xor_shifted(c, b, used, m);
+                len = n + 1 - len;
+                b.swap(t);
+                m = 1;
+            } else {
+                xor_shifted(c, b, used, m);
+                m++;
+            }
+        }
+        if (len != static_cast<size_t>(mexp)) {
+            //throw runtime_error("wrong characteristic polynomial!");
+            throw "wrong characteristic polynomial!";
+        }
+        // reciprocal of connection polynomial
+        poly_t phi(poly_words, 0);
+        for (int i = 0; i <= mexp; i++) {
+            if (get_bit(c, mexp - i)) {
+                set_bit(phi, i);
+            }
+        }
+        return phi;
+    }
+
+    const poly_t& get_phi()
+    {
+        static const poly_t phi = characteristic_polynomial();
+        return phi;
+    }
+
+    /*
+     * p = p mod phi, where degree of p is less than 2 * mexp - 1.
+     */
+    void reduce(poly_t& p, const poly_t& phi)
+    {
+        for (int i = 2 * mexp - 2; i >= mexp; i--) {
+            if (get_bit(p, i)) {
+                xor_shifted(p, phi, poly_words, i - mexp);
+            }
+        }
+        p.resize(poly_words);
+    }
+
+    /*
+     * p = p^2 mod phi
+     */
+    void square_mod(poly_t& p, const poly_t& phi)
+    {
+        poly_t sq(2 * poly_words, 0);
+        for (int i = 0; i < poly_words; i++) {
+            uint64_t lo = 0;
+            uint64_t hi = 0;
+            for (int j = 0; j < 32; j++) {
+                lo |= ((p[i] >> j) & 1) << (2 * j);
+                hi |= ((p[i] >> (j + 32)) & 1) << (2 * j);
+            }
+            sq[2 * i] = lo;
+            sq[2 * i + 1] = hi;
+        }
+        reduce(sq, phi);
+        p.swap(sq);
+    }
+
+    /*
+     * p = p * x mod phi
+     */
+    void mul_x_mod(poly_t& p, const poly_t& phi)
+    {
+        uint64_t carry = 0;
+        for (int i = 0; i < poly_words; i++) {
+            uint64_t next = p[i] >> 63;
+            p[i] = (p[i] << 1) | carry;
+            carry = next;
+        }
+        if (get_bit(p, mexp)) {
+            for (int i = 0; i < poly_words; i++) {
+                p[i] ^= phi[i];
+            }
+        }
+    }
+}
+
+namespace MCQMCIntegration {
+
+    void MersenneTwister64::seed(uint64_t seed)
+    {
+        state[0] = seed;
+        for (int i = 1; i < state_size; i++) {
+            state[i] = UINT64_C(6364136223846793005)
+                * (state[i - 1] ^ (state[i - 1] >> 62)) + i;
+        }
+        index = 0;
+    }
+
+    void MersenneTwister64::discard(uint64_t steps)
+    {
+        for (uint64_t i = 0; i < steps; i++) {
+            nextState();
+        }
+    }
+
+    void MersenneTwister64::jump(uint64_t steps)
+    {
+        MTJumpPolynomial jump(steps);
+        jump.apply(*this);
+    }
+
+    /*
+     * the same as operator() without tempering.
+     */
+    void MersenneTwister64::nextState()
+    {
+        int i = index;
+        int i1 = i + 1 == state_size ? 0 : i + 1;
+        int im = i + shift_size >= state_size
+            ? i + shift_size - state_size : i + shift_size;
+        uint64_t y = (state[i] & UINT64_C(0xFFFFFFFF80000000))
+            | (state[i1] & UINT64_C(0x7FFFFFFF));
+        state[i] = state[im] ^ (y >> 1)
+            ^ ((y & 1) ? UINT64_C(0xB5026F5AA96619E9) : 0);
+        index = i1;
+    }
+
+    /*
+     * state in order of index is a vector of F2 linear space.
+     */
+    void MersenneTwister64::addState(const MersenneTwister64& that)
+    {
+        int i = index;
+        int j = that.index;
+        for (int k = 0; k < state_size; k++) {
+            state[i] ^= that.state[j];
+            i = i + 1 == state_size ? 0 : i + 1;
+            j = j + 1 == state_size ? 0 : j + 1;
+        }
+    }
+
+    bool MersenneTwister64::operator==(const MersenneTwister64& that) const
+    {
+        // lower bits of the oldest word are not used
+        int i = index;
+        int j = that.index;
+        if (((state[i] ^ that.state[j]) >> 31) != 0) {
+            return false;
+        }
+        for (int k = 1; k < state_size; k++) {
+            i = i + 1 == state_size ? 0 : i + 1;
+            j = j + 1 == state_size ? 0 : j + 1;
+            if (state[i] != that.state[j]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void MersenneTwister64::getState(uint64_t array[]) const
+    {
+        for (int k = 0; k < state_size; k++) {
+            array[k] = state[(index + k) % state_size];
+        }
+    }
+
+    void MersenneTwister64::setState(const uint64_t array[])
+    {
+        memcpy(state, array, sizeof(state));
+        index = 0;
+    }
+
+    MTJumpPolynomial::MTJumpPolynomial(uint64_t steps)
+    {
+        const poly_t& phi = get_phi();
+        this->steps = steps;
+        // x^steps mod phi
+        poly.assign(poly_words, 0);
+        poly[0] = 1;
+        int top = 63;
+        while (top >= 0 && ((steps >> top) & 1) == 0) {
+            top--;
+        }
+        for (int i = top; i >= 0; i--) {
+            square_mod(poly, phi);
+            if ((steps >> i) & 1) {
+                mul_x_mod(poly, phi);
+            }
+        }
+    }
+
+    void MTJumpPolynomial::apply(MersenneTwister64& rand) const
+    {
+        // Horner's method, sum of poly[i] T^i state
+        MersenneTwister64 work(rand);
+        memset(work.state, 0, sizeof(work.state));
+        for (int i = mexp - 1; i >= 0; i--) {
+            work.nextState();
+            if (get_bit(poly, i)) {
+                work.addState(rand);
+            }
+        }
+        rand = work;
+    }
+}
@@ -0,0 +1,391 @@
+/**
+ * @file PointSetCache.cpp
+ *
+ * @brief Cache of generated point sets in memory mapped files.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include "digital.h"
+#include "bit_operator.h"
+#include "mapped_file.h"
+#include <MCQMCIntegration/PointSetCache.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#if defined(HAVE_DIRENT_H)
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    const string file_prefix = "mcqmc-points-";
+
+    // the same conversion as DigitalNet
+    const int get_max = 64 - 53;
+    const double factor = exp2(-53);
+    const double eps = exp2(-64);
+
+    atomic<unsigned> temp_count(0);
+
+    size_t elementSize(PointFormat format)
+    {
+        switch (format) {
+        case POINT_FLOAT:
+            return sizeof(float);
+        case POINT_INTEGER:
+            return sizeof(uint64_t);
+        default:
+            return sizeof(double);
+        }
+    }
+
+    /*
+     * FNV-1a
+     */
+    class Hash {
+    public:
+        Hash() {
+            value = UINT64_C(0xcbf29ce484222325);
+        }
+        void add(uint64_t x) {
+            for (int i = 0; i < 8; i++) {
+                value ^= (x >> (i * 8)) & 0xff;
+                value *= UINT64_C(0x100000001b3);
+            }
+        }
+        uint64_t get() const {
+            return value;
+        }
+    private:
+        uint64_t value;
+    };
+
+    uint64_t pointSetHash(DigitalNet<uint64_t>& net, PointFormat format)
+    {
+        uint32_t s = net.getS();
+        uint32_t m = net.getM();
+        Hash hash;
+        hash.add(s);
+        hash.add(m);
+        hash.add(format);
+        for (uint32_t k = 0; k < m; k++) {
+            for (uint32_t j = 0; j < s; j++) {
+                hash.add(net.getBase(k, j));
+            }
+        }
+        const uint64_t * shift = net.getShift();
+        for (uint32_t j = 0; j < s; j++) {
+            hash.add(shift[j]);
+        }
+        return hash.get();
+    }
+
+    size_t fileSize(uint32_t s, uint32_t m, PointFormat format)
+    {
+        return DIGITAL_POINTS_OFFSET
+            + (static_cast<size_t>(1) << m) * s * elementSize(format);
+    }
+
+    /*
+     * write all points in gray code order.
+     */
+    bool writePoints(ostream& os, DigitalNet<uint64_t>& net,
+                     PointFormat format)
+    {
+        uint32_t s = net.getS();
+        uint32_t m = net.getM();
+        vector<uint64_t> base(static_cast<size_t>(s) * m);
+        for (uint32_t k = 0; k < m; k++) {
+            for (uint32_t j = 0; j < s; j++) {
+                base[k * s + j] = net.getBase(k, j);
+            }
+        }
+        const uint64_t * shift = net.getShift();
+        vector<uint64_t> point_base(s, 0);
+        size_t esize = elementSize(format);
+        // write about 1MB at once
+        size_t block = (1 << 20) / (s * esize) + 1;
+        vector<char> buffer(block * s * esize);
+        size_t used = 0;
+        uint64_t size = UINT64_C(1) << m;
+        for (uint64_t idx = 0; idx < size; idx++) {
+            if (idx > 0) {
+                const uint64_t * row = &base[tailingZeroBit(idx) * s];
+                for (uint32_t j = 0; j < s; j++) {
+                    point_base[j] ^= row[j];
+                }
+            }
+            char * p = &buffer[used];
+            for (uint32_t j = 0; j < s; j++) {
+                uint64_t tmp = (point_base[j] ^ shift[j]) >> get_max;
+                if (format == POINT_INTEGER) {
+                    memcpy(p + j * esize, &tmp, esize);
+                } else {
+                    double x = static_cast<double>(tmp) * factor + eps;
+                    if (format == POINT_FLOAT) {
+                        float f = static_cast<float>(x);
+                        memcpy(p + j * esize, &f, esize);
+                    } else {
+                        memcpy(p + j * esize, &x, esize);
+                    }
+                }
+            }
+            used += s * esize;
+            if (used == buffer.size() || idx == size - 1) {
+                os.write(&buffer[0], used);
+                used = 0;
+            }
+        }
+        return static_cast<bool>(os);
+    }
+
+    bool validHeader(const MappedFile& file, uint32_t s, uint32_t m,
+                     PointFormat format, uint64_t hash)
+    {
+        if (file.size() != fileSize(s, m, format)) {
+            return false;
+        }
+        digital_net_points_header_t header;
+        memcpy(&header, file.begin(), sizeof(header));
+        return header.magic == DIGITAL_POINTS_MAGIC
+            && header.version == DIGITAL_POINTS_VERSION
+            && header.format == static_cast<uint32_t>(format)
+            && header.s == s
+            && header.m == m
+            && header.hash == hash;
+    }
+
+    void touch(const string& path)
+    {
+#if defined(HAVE_DIRENT_H)
+        utime(path.c_str(), NULL);
+#else
+        (void)path;
+#endif
+    }
+}
+
+namespace MCQMCIntegration {
+
+    MappedPointSet::MappedPointSet()
+    {
+        s = 0;
+        m = 0;
+        format = POINT_DOUBLE;
+        points = NULL;
+        file = new MappedFile;
+    }
+
+    MappedPointSet::~MappedPointSet()
+    {
+        delete file;
+    }
+
+    void MappedPointSet::getPoint(uint64_t index, double point[]) const
+    {
+        size_t first = index * s;
+        switch (format) {
+        case POINT_FLOAT: {
+            const float * p = static_cast<const float *>(points) + first;
+            for (uint32_t j = 0; j < s; j++) {
+                point[j] = p[j];
+            }
+            break;
+        }
+        case POINT_INTEGER: {
+            const uint64_t * p = static_cast<const uint64_t *>(points) + first;
+            for (uint32_t j = 0; j < s; j++) {
+                point[j] = static_cast<double>(p[j]) * factor + eps;
+            }
+            break;
+        }
+        default: {
+            const double * p = static_cast<const double *>(points) + first;
+            for (uint32_t j = 0; j < s; j++) {
+                point[j] = p[j];
+            }
+            break;
+        }
+        }
+    }
+
+    PointSetCache::PointSetCache(const std::string& directory,
+                                 uint64_t maxBytes)
+        : directory(directory)
+    {
+        if (this->directory.empty()) {
+            this->directory = ".";
+        }
+        if (this->directory[this->directory.size() - 1] != '/') {
+            this->directory += "/";
+        }
+        this->maxBytes = maxBytes;
+        hits = 0;
+        misses = 0;
+    }
+
+    shared_ptr<const MappedPointSet>
+    PointSetCache::get(DigitalNet<uint64_t>& net, PointFormat format)
+    {
+        uint32_t s = net.getS();
+        uint32_t m = net.getM();
+        net.requireDimension(s);
+        uint64_t hash = pointSetHash(net, format);
+        stringstream ss;
+        ss << directory << file_prefix << s << "-" << m << "-"
+           << hex << setw(16) << setfill('0') << hash
+           << "." << static_cast<int>(format);
+        string path = ss.str();
+        shared_ptr<MappedPointSet> set(new MappedPointSet);
+        set->s = s;
+        set->m = m;
+        set->format = format;
+        bool hit = set->file->open(path)
+            && validHeader(*set->file, s, m, format, hash);
+        if (hit) {
+            touch(path);
+        } else {
+            stringstream ts;
+#if defined(HAVE_DIRENT_H)
+            ts << path << ".tmp." << getpid() << "." << temp_count++;
+#else
+            ts << path << ".tmp." << temp_count++;
+#endif
+            string temp = ts.str();
+            ofstream ofs(temp.c_str(), ios::out | ios::binary | ios::trunc);
+            digital_net_points_header_t header;
+            memset(&header, 0, sizeof(header));
+            header.magic = DIGITAL_POINTS_MAGIC;
+            header.version = DIGITAL_POINTS_VERSION;
+            header.format = format;
+            header.s = s;
+            header.m = m;
+            header.hash = hash;
+            char head[DIGITAL_POINTS_OFFSET];
+            memset(head, 0, sizeof(head));
+            memcpy(head, &header, sizeof(header));
+            ofs.write(head, sizeof(head));
+            bool r = ofs && writePoints(ofs, net, format);
+            ofs.close();
+            if (!r || ofs.fail()
+                || rename(temp.c_str(), path.c_str()) != 0) {
+                remove(temp.c_str());
+                //throw runtime_error("can't write point set!");
+                throw "can't write point set!";
+            }
+            if (!set->file->open(path)
+                || !validHeader(*set->file, s, m, format, hash)) {
+                //throw runtime_error("can't map point set!");
+                throw "can't map point set!";
+            }
+        }
+        set->file->adviseSequential();
+        set->points = set->file->begin() + DIGITAL_POINTS_OFFSET;
+        {
+            unique_lock<mutex> lock(mtx);
+            if (hit) {
+                hits++;
+            } else {
+                misses++;
+            }
+        }
+        if (!hit) {
+            // mapping is still valid if the file is removed here
+            cleanup();
+        }
+        return set;
+    }
+
+    void PointSetCache::cleanup()
+    {
+        removeFiles(maxBytes);
+    }
+
+    void PointSetCache::clear()
+    {
+        removeFiles(0);
+    }
+
+    void PointSetCache::removeFiles(uint64_t limit)
+    {
+#if defined(HAVE_DIRENT_H)
+        struct cache_file {
+            time_t mtime;
+            uint64_t size;
+            string path;
+            bool operator<(const cache_file& that) const {
+                return mtime < that.mtime;
+            }
+        };
+        DIR * dir = opendir(directory.c_str());
+        if (dir == NULL) {
+            return;
+        }
+        vector<cache_file> files;
+        uint64_t total = 0;
+        struct dirent * ent;
+        while ((ent = readdir(dir)) != NULL) {
+            string name = ent->d_name;
+            if (name.compare(0, file_prefix.size(), file_prefix) != 0
+                || name.find(".tmp.") != string::npos) {
+                continue;
+            }
+            cache_file f;
+            f.path = directory + name;
+            struct stat st;
+            if (stat(f.path.c_str(), &st) != 0) {
+                continue;
+            }
+            f.mtime = st.st_mtime;
+            f.size = st.st_size;
+            total += f.size;
+            files.push_back(f);
+        }
+        closedir(dir);
+        // least recently used first
+        stable_sort(files.begin(), files.end());
+        for (size_t i = 0; i < files.size() && total > limit; i++) {
+            if (remove(files[i].path.c_str()) == 0) {
+                total -= files[i].size;
+            }
+        }
+#else
+        (void)limit;
+#endif
+    }
+
+    uint64_t PointSetCache::getHits()
+    {
+        unique_lock<mutex> lock(mtx);
+        return hits;
+    }
+
+    uint64_t PointSetCache::getMisses()
+    {
+        unique_lock<mutex> lock(mtx);
+        return misses;
+    }
+}
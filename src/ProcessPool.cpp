@@ -0,0 +1,184 @@
+/**
+ * @file ProcessPool.cpp
+ *
+ * @brief Worker processes on a node.
+ *
+ * Shared area is an anonymous MAP_SHARED mapping made before fork(2):
+ * the counter of next job, status of each job and results of jobs. A
+ * worker which fails marks its job and exits with non zero status, and
+ * the caller checks both after waiting for all workers.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include <MCQMCIntegration/ProcessPool.h>
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <new>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#if defined(HAVE_FORK) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define MCQMC_USE_FORK 1
+#endif
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    enum job_status {
+        JOB_WAITING = 0,
+        JOB_DONE = 1,
+        JOB_FAILED = 2
+    };
+
+#if defined(MCQMC_USE_FORK)
+    struct shared_header {
+        atomic<uint64_t> next;
+    };
+
+    size_t align16(size_t x)
+    {
+        return (x + 15) & ~static_cast<size_t>(15);
+    }
+
+    /*
+     * main of worker process, never returns.
+     */
+    void work(unsigned worker, unsigned processes, size_t count,
+              size_t resultSize, const ProcessPool::Job& job,
+              shared_header * header, uint8_t * status, uint8_t * results)
+    {
+        int code = 0;
+#if ATOMIC_LLONG_LOCK_FREE == 2
+        (void)processes;
+        for (;;) {
+            uint64_t i = header->next.fetch_add(1);
+#else
+        // atomic in shared memory may use a lock of this process
+        (void)header;
+        for (uint64_t i = worker; ; i += processes) {
+#endif
+            if (i >= count) {
+                break;
+            }
+            try {
+                job(worker, i, results + i * resultSize);
+                status[i] = JOB_DONE;
+            } catch (...) {
+                status[i] = JOB_FAILED;
+                code = 1;
+                break;
+            }
+        }
+        cout.flush();
+        fflush(NULL);
+        _exit(code);
+    }
+#endif
+}
+
+namespace MCQMCIntegration {
+
+    ProcessPool::ProcessPool(unsigned processes)
+    {
+        if (processes == 0) {
+            processes = thread::hardware_concurrency();
+            if (processes == 0) {
+                processes = 1;
+            }
+        }
+        this->processes = processes;
+    }
+
+    void ProcessPool::run(size_t count, size_t resultSize, const Job& job,
+                          void * results)
+    {
+        if (count == 0) {
+            return;
+        }
+#if defined(MCQMC_USE_FORK)
+        size_t statusOffset = align16(sizeof(shared_header));
+        size_t resultOffset = align16(statusOffset + count);
+        size_t length = resultOffset + count * resultSize;
+        void * addr = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            //throw runtime_error("can't map shared memory!");
+            throw "can't map shared memory!";
+        }
+        uint8_t * base = static_cast<uint8_t *>(addr);
+        shared_header * header = new (base) shared_header;
+        header->next = 0;
+        uint8_t * status = base + statusOffset;
+        uint8_t * area = base + resultOffset;
+        memset(status, JOB_WAITING, count);
+        // buffered output should not be written twice
+        cout.flush();
+        fflush(NULL);
+        unsigned workers = processes;
+        if (workers > count) {
+            workers = static_cast<unsigned>(count);
+        }
+        vector<pid_t> pids;
+        for (unsigned w = 0; w < workers; w++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                work(w, workers, count, resultSize, job, header, status,
+                     area);
+            }
+            if (pid < 0) {
+                break;
+            }
+            pids.push_back(pid);
+        }
+        // jobs of workers not made are checked by status
+        bool failed = pids.empty();
+        for (size_t i = 0; i < pids.size(); i++) {
+            int st;
+            while (waitpid(pids[i], &st, 0) < 0) {
+                if (errno != EINTR) {
+                    st = -1;
+                    break;
+                }
+            }
+            if (st != 0) {
+                failed = true;
+            }
+        }
+        for (size_t i = 0; i < count && !failed; i++) {
+            failed = status[i] != JOB_DONE;
+        }
+        if (!failed) {
+            memcpy(results, area, count * resultSize);
+        }
+        header->~shared_header();
+        munmap(addr, length);
+        if (failed) {
+            //throw runtime_error("worker process failed!");
+            throw "worker process failed!";
+        }
+#else
+        uint8_t * area = static_cast<uint8_t *>(results);
+        for (size_t i = 0; i < count; i++) {
+            job(0, i, area + i * resultSize);
+        }
+#endif
+    }
+}
@@ -0,0 +1,255 @@
+/**
+ * @file ThreadPool.cpp
+ *
+ * @brief Persistent pool of worker threads.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include <MCQMCIntegration/ThreadPool.h>
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+    void bindCPU(int cpu)
+    {
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP)
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            return;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        // this is a hint, failure is ignored.
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+}
+
+namespace MCQMCIntegration {
+
+    ThreadPool::ThreadPool(unsigned threads, const std::vector<int>& cpus)
+        : cpus(cpus)
+    {
+        job = NULL;
+        count = 0;
+        nextIndex = 0;
+        finished = 0;
+        generation = 0;
+        stopping = false;
+        if (threads == 0) {
+            threads = thread::hardware_concurrency();
+            if (threads == 0) {
+                threads = 1;
+            }
+        }
+        for (unsigned i = 0; i < threads; i++) {
+            this->threads.push_back(thread(&ThreadPool::work, this, i));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            unique_lock<mutex> lock(mtx);
+            stopping = true;
+            startCond.notify_all();
+        }
+        for (size_t i = 0; i < threads.size(); i++) {
+            threads[i].join();
+        }
+    }
+
+    void ThreadPool::run(size_t count, const Job& job)
+    {
+        if (count == 0) {
+            return;
+        }
+        unique_lock<mutex> runLock(runMtx);
+        unique_lock<mutex> lock(mtx);
+        this->job = &job;
+        this->count = count;
+        nextIndex = 0;
+        finished = 0;
+        error = exception_ptr();
+        generation++;
+        startCond.notify_all();
+        while (finished < count) {
+            doneCond.wait(lock);
+        }
+        this->job = NULL;
+        if (error) {
+            exception_ptr e = error;
+            error = exception_ptr();
+            rethrow_exception(e);
+        }
+    }
+
+    void ThreadPool::post(const Task& task)
+    {
+        unique_lock<mutex> lock(mtx);
+        tasks.push_back(task);
+        startCond.notify_one();
+    }
+
+    StealingScheduler::StealingScheduler(size_t blocks, unsigned slots,
+                                         double target)
+    {
+        if (slots == 0) {
+            slots = 1;
+        }
+        this->target = target;
+        for (unsigned i = 0; i < slots; i++) {
+            Range * range = new Range;
+            range->first = blocks * i / slots;
+            range->last = blocks * (i + 1) / slots;
+            range->chunk = 1;
+            range->perBlock = 0;
+            ranges.push_back(unique_ptr<Range>(range));
+        }
+    }
+
+    bool StealingScheduler::next(unsigned slot, size_t * first, size_t * last)
+    {
+        Range& own = *ranges[slot];
+        for (;;) {
+            {
+                unique_lock<mutex> lock(own.mtx);
+                if (own.first < own.last) {
+                    size_t n = min(own.chunk, own.last - own.first);
+                    *first = own.first;
+                    *last = own.first + n;
+                    own.first += n;
+                    return true;
+                }
+            }
+            if (!steal(slot)) {
+                return false;
+            }
+        }
+    }
+
+    bool StealingScheduler::steal(unsigned slot)
+    {
+        size_t n = ranges.size();
+        for (size_t k = 1; k < n; k++) {
+            Range& victim = *ranges[(slot + k) % n];
+            size_t first;
+            size_t last;
+            {
+                unique_lock<mutex> lock(victim.mtx);
+                size_t remain = victim.last - victim.first;
+                if (remain == 0) {
+                    continue;
+                }
+                // latter half, victim keeps the part it is going to take
+                first = victim.first + remain / 2;
+                last = victim.last;
+                victim.last = first;
+            }
+            Range& own = *ranges[slot];
+            unique_lock<mutex> lock(own.mtx);
+            own.first = first;
+            own.last = last;
+            return true;
+        }
+        return false;
+    }
+
+    void StealingScheduler::report(unsigned slot, size_t blocks,
+                                   double seconds)
+    {
+        if (blocks == 0) {
+            return;
+        }
+        Range& own = *ranges[slot];
+        unique_lock<mutex> lock(own.mtx);
+        double perBlock = seconds / blocks;
+        if (own.perBlock == 0) {
+            own.perBlock = perBlock;
+        } else {
+            // moving average, cost of integrand may vary by region
+            own.perBlock = 0.75 * own.perBlock + 0.25 * perBlock;
+        }
+        size_t chunk = 1;
+        if (own.perBlock > 0 && target > own.perBlock) {
+            chunk = static_cast<size_t>(target / own.perBlock);
+        }
+        // keep something to be stolen
+        size_t remain = own.last - own.first;
+        if (chunk > remain / 2) {
+            chunk = remain / 2;
+        }
+        own.chunk = max(chunk, static_cast<size_t>(1));
+    }
+
+    void ThreadPool::work(unsigned worker)
+    {
+        if (!cpus.empty()) {
+            bindCPU(cpus[worker % cpus.size()]);
+        }
+        uint64_t seen = 0;
+        unique_lock<mutex> lock(mtx);
+        for (;;) {
+            while (!stopping && tasks.empty()
+                   && (generation == seen || nextIndex >= count)) {
+                if (generation != seen) {
+                    // all jobs of this generation are taken
+                    seen = generation;
+                }
+                startCond.wait(lock);
+            }
+            bool hasJob = generation != seen && nextIndex < count;
+            if (!hasJob) {
+                if (tasks.empty()) {
+                    // stopping
+                    return;
+                }
+                Task task = tasks.front();
+                tasks.pop_front();
+                lock.unlock();
+                try {
+                    task(worker);
+                } catch (...) {
+                    // nobody waits for the task
+                }
+                lock.lock();
+                continue;
+            }
+            size_t index = nextIndex++;
+            const Job * current = job;
+            lock.unlock();
+            exception_ptr e;
+            try {
+                (*current)(worker, index);
+            } catch (...) {
+                e = current_exception();
+            }
+            lock.lock();
+            if (e && !error) {
+                error = e;
+            }
+            finished++;
+            if (finished == count) {
+                doneCond.notify_all();
+            }
+        }
+    }
+}
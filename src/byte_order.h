@@ -0,0 +1,73 @@
+#pragma once
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+/**
+ * @file byte_order.h
+ *
+ * @brief little endian encoding of saved states.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <inttypes.h>
+#include <cstring>
+#include <iostream>
+
+namespace MCQMCIntegration {
+    inline void put_le64(uint8_t buffer[], uint64_t x)
+    {
+        for (int i = 0; i < 8; i++) {
+            buffer[i] = static_cast<uint8_t>(x >> (i * 8));
+        }
+    }
+
+    inline uint64_t get_le64(const uint8_t buffer[])
+    {
+        uint64_t x = 0;
+        for (int i = 0; i < 8; i++) {
+            x |= static_cast<uint64_t>(buffer[i]) << (i * 8);
+        }
+        return x;
+    }
+
+    inline uint64_t double_bits(double x)
+    {
+        uint64_t u;
+        memcpy(&u, &x, sizeof(u));
+        return u;
+    }
+
+    inline double bits_double(uint64_t u)
+    {
+        double x;
+        memcpy(&x, &u, sizeof(x));
+        return x;
+    }
+
+    inline void write_le64(std::ostream& os, uint64_t x)
+    {
+        uint8_t buffer[8];
+        put_le64(buffer, x);
+        os.write(reinterpret_cast<char *>(buffer), 8);
+    }
+
+    inline bool read_le64(std::istream& is, uint64_t * x)
+    {
+        uint8_t buffer[8];
+        is.read(reinterpret_cast<char *>(buffer), 8);
+        if (!is) {
+            return false;
+        }
+        *x = get_le64(buffer);
+        return true;
+    }
+}
+#endif // BYTE_ORDER_H
@@ -36,6 +36,64 @@ struct digital_net_data_t {
     uint64_t data[0];
 };
 
+#define DIGITAL_PACKED_MAGIC UINT64_C(0x36b5951d82b67242)
+#define DIGITAL_PACKED_VERSION 1
+
+/*
+ * header of compact format, followed by m pairs of (shift, width) bytes
+ * padded to 8 bytes, and size words of packed rows. In files, all
+ * fields are little endian, see packed_base.cpp.
+ */
+struct digital_net_packed_header_t {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t s;
+    uint32_t m;
+    uint32_t precision;
+    int64_t tvalue;
+    double wafom;
+    uint64_t size;
+};
+
+#define DIGITAL_SHARED_MAGIC UINT64_C(0x36b5951d82b67243)
+#define DIGITAL_SHARED_VERSION 1
+
+/*
+ * header of shared memory segment of base matrix, followed by
+ * s * m 64-bit integers from offset DIGITAL_SHARED_OFFSET.
+ */
+struct digital_net_shared_header_t {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t ready;
+    uint32_t id;
+    uint32_t bit;
+    uint32_t s;
+    uint32_t m;
+    int64_t tvalue;
+    double wafom;
+};
+
+#define DIGITAL_SHARED_OFFSET 64
+
+#define DIGITAL_POINTS_MAGIC UINT64_C(0x36b5951d82b67244)
+#define DIGITAL_POINTS_VERSION 1
+
+/*
+ * header of point set cache file, followed by 2^m points of s elements
+ * from offset DIGITAL_POINTS_OFFSET.
+ */
+struct digital_net_points_header_t {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t s;
+    uint32_t m;
+    uint64_t hash;
+};
+
+#define DIGITAL_POINTS_OFFSET 64
+
 //typedef struct DIGITAL_NET_HEADER_T digital_net_header_t;
 //typedef struct DIGITAL_NET_DATA_T digital_net_data_t;
 
@@ -0,0 +1,247 @@
+/**
+ * @file embed_data_main.cpp
+ *
+ * @brief generate embedded_data.cpp from data directory.
+ *
+ * Sobol base matrix of the first dimensions is computed from
+ * sobolbase.dat, and 32-bit and 64-bit NXLW and SOLW nets of small s
+ * and m are selected from digitalnet.sqlite3, if it exists.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <inttypes.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <sqlite3.h>
+#include "sobolpoint.h"
+#include "mapped_file.h"
+
+using namespace std;
+using namespace MCQMCIntegration;
+
+namespace {
+    const uint32_t sobol_s = 512;
+    const uint32_t sobol_m = 31;
+    const uint32_t db_s_max = 32;
+    const uint32_t db_m_max = 20;
+
+    const int db_ids[] = {3, 4};
+    const size_t db_ids_size = sizeof(db_ids) / sizeof(db_ids[0]);
+
+    struct net_data {
+        int id;
+        int bitsize;
+        uint32_t s;
+        uint32_t m;
+        int64_t tvalue;
+        double wafom;
+        vector<uint64_t> data;
+    };
+
+    void printArray(const vector<uint64_t>& data)
+    {
+        for (size_t i = 0; i < data.size(); i++) {
+            if (i % 2 == 0) {
+                cout << "       ";
+            }
+            cout << " UINT64_C(0x" << hex << setw(16) << setfill('0')
+                 << data[i] << "),";
+            if (i % 2 == 1 || i == data.size() - 1) {
+                cout << endl;
+            }
+        }
+        cout << dec << setfill(' ');
+    }
+
+    void printDouble(double x)
+    {
+        if (isnan(x)) {
+            cout << "NAN";
+        } else {
+            cout << setprecision(17) << x;
+        }
+    }
+
+    /*
+     * true when all nets of @b id in database are within db_s_max and
+     * db_m_max, that is, all of them are embedded.
+     */
+    bool isComplete(sqlite3 * db, int id)
+    {
+        string strsql = "select count(*) from digitalnet";
+        strsql += " where id = ? and (dimr > ? or dimf2 > ?);";
+        sqlite3_stmt* select_sql = NULL;
+        int r = sqlite3_prepare_v2(db, strsql.c_str(), -1, &select_sql, NULL);
+        if (r != SQLITE_OK || select_sql == NULL) {
+            cerr << "sqlite3_prepare error code = " << dec << r << endl;
+            cerr << sqlite3_errmsg(db) << endl;
+            return false;
+        }
+        sqlite3_bind_int(select_sql, 1, id);
+        sqlite3_bind_int(select_sql, 2, db_s_max);
+        sqlite3_bind_int(select_sql, 3, db_m_max);
+        bool complete = false;
+        if (sqlite3_step(select_sql) == SQLITE_ROW) {
+            complete = sqlite3_column_int(select_sql, 0) == 0;
+        }
+        sqlite3_finalize(select_sql);
+        return complete;
+    }
+
+    int selectNets(const string& path, vector<net_data>& nets,
+                   vector<int>& complete)
+    {
+        sqlite3 *db;
+        int r = sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, NULL);
+        if (r != SQLITE_OK) {
+            sqlite3_close_v2(db);
+            return -1;
+        }
+        string strsql = "select id, bitsize, dimr, dimf2, wafom, tvalue, data";
+        strsql += " from digitalnet";
+        strsql += " where bitsize in (32, 64) and id in (3, 4)";
+        strsql += " and dimr <= ? and dimf2 <= ?";
+        strsql += " order by id, bitsize, dimr, dimf2;";
+        sqlite3_stmt* select_sql = NULL;
+        r = sqlite3_prepare_v2(db, strsql.c_str(), -1, &select_sql, NULL);
+        if (r != SQLITE_OK || select_sql == NULL) {
+            cerr << "sqlite3_prepare error code = " << dec << r << endl;
+            cerr << sqlite3_errmsg(db) << endl;
+            sqlite3_close_v2(db);
+            return -2;
+        }
+        sqlite3_bind_int(select_sql, 1, db_s_max);
+        sqlite3_bind_int(select_sql, 2, db_m_max);
+        while ((r = sqlite3_step(select_sql)) == SQLITE_ROW) {
+            net_data net;
+            net.id = sqlite3_column_int(select_sql, 0);
+            net.bitsize = sqlite3_column_int(select_sql, 1);
+            net.s = sqlite3_column_int(select_sql, 2);
+            net.m = sqlite3_column_int(select_sql, 3);
+            if (sqlite3_column_type(select_sql, 4) == SQLITE_NULL) {
+                net.wafom = NAN;
+            } else {
+                net.wafom = sqlite3_column_double(select_sql, 4);
+            }
+            if (sqlite3_column_type(select_sql, 5) == SQLITE_NULL) {
+                net.tvalue = -1;
+            } else {
+                net.tvalue = sqlite3_column_int(select_sql, 5);
+            }
+            const char * text
+                = reinterpret_cast<const char *>(
+                    sqlite3_column_text(select_sql, 6));
+            int bytes = sqlite3_column_bytes(select_sql, 6);
+            TextScanner scanner(text, text + bytes);
+            net.data.resize(static_cast<size_t>(net.s) * net.m);
+            bool ok = true;
+            for (size_t i = 0; i < net.data.size(); i++) {
+                if (!scanner.next(net.data[i])) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (!ok) {
+                cerr << "too less data id = " << net.id
+                     << " s = " << net.s << " m = " << net.m << endl;
+                continue;
+            }
+            nets.push_back(net);
+        }
+        sqlite3_finalize(select_sql);
+        if (r != SQLITE_DONE) {
+            sqlite3_close_v2(db);
+            return -3;
+        }
+        for (size_t i = 0; i < db_ids_size; i++) {
+            if (isComplete(db, db_ids[i])) {
+                complete.push_back(db_ids[i]);
+            }
+        }
+        sqlite3_close_v2(db);
+        return 0;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc < 2) {
+        cout << "usage:" << endl;
+        cout << argv[0] << " data-directory" << endl;
+        return 1;
+    }
+    string dir = argv[1];
+    if (dir.empty() || dir[dir.size() - 1] != '/') {
+        dir += "/";
+    }
+    string sobolpath = dir + "sobolbase.dat";
+    SobolColumnReader reader(sobol_s, sobol_m);
+    if (!reader.open(sobolpath)) {
+        cerr << "can't open " << sobolpath << endl;
+        return -1;
+    }
+    vector<uint64_t> sobol(static_cast<size_t>(sobol_s) * sobol_m);
+    if (!reader.read(sobol_s, &sobol[0])) {
+        cerr << "can't read " << sobolpath << endl;
+        return -1;
+    }
+    vector<net_data> nets;
+    vector<int> complete;
+    // database is optional
+    selectNets(dir + "digitalnet.sqlite3", nets, complete);
+
+    cout << "/*" << endl;
+    cout << " * generated by embed_data, do not edit." << endl;
+    cout << " */" << endl;
+    cout << "#include <cmath>" << endl;
+    cout << "#include \"embedded_data.h\"" << endl;
+    cout << endl;
+    cout << "namespace {" << endl;
+    for (size_t k = 0; k < nets.size(); k++) {
+        cout << "    const uint64_t net_" << k << "[] = {" << endl;
+        printArray(nets[k].data);
+        cout << "    };" << endl;
+    }
+    cout << "}" << endl;
+    cout << endl;
+    cout << "namespace MCQMCIntegration {" << endl;
+    cout << "    const uint32_t embedded_sobol_s = " << sobol_s << ";" << endl;
+    cout << "    const uint32_t embedded_sobol_m = " << sobol_m << ";" << endl;
+    cout << "    const uint64_t embedded_sobol_base[] = {" << endl;
+    printArray(sobol);
+    cout << "    };" << endl;
+    cout << "    const embedded_net_t embedded_nets[] = {" << endl;
+    for (size_t k = 0; k < nets.size(); k++) {
+        cout << "        {" << nets[k].id << ", " << nets[k].bitsize << ", "
+             << nets[k].s << ", " << nets[k].m << ", " << nets[k].tvalue
+             << ", ";
+        printDouble(nets[k].wafom);
+        cout << ", net_" << k << "}," << endl;
+    }
+    // sentinel, array should not be empty
+    cout << "        {-1, 0, 0, 0, -1, NAN, NULL}" << endl;
+    cout << "    };" << endl;
+    cout << "    const size_t embedded_nets_size = " << nets.size() << ";"
+         << endl;
+    cout << "    const int embedded_complete_ids[] = {";
+    for (size_t k = 0; k < complete.size(); k++) {
+        cout << complete[k] << ", ";
+    }
+    cout << "-1};" << endl;
+    cout << "    const size_t embedded_complete_ids_size = " << complete.size()
+         << ";" << endl;
+    cout << "}" << endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#ifndef EMBEDDED_DATA_H
+#define EMBEDDED_DATA_H
+/**
+ * @file embedded_data.h
+ *
+ * @brief Digital net data compiled into the library.
+ *
+ * The definitions are in embedded_data.cpp, which is generated by
+ * embed_data at build time.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <inttypes.h>
+#include <cstddef>
+
+namespace MCQMCIntegration {
+    /**
+     * base matrix of a digital net in database. 32-bit nets are also
+     * stored in uint64_t.
+     */
+    struct embedded_net_t {
+        int id;
+        int bitsize;
+        uint32_t s;
+        uint32_t m;
+        int64_t tvalue;
+        double wafom;
+        const uint64_t * data;
+    };
+
+    /**
+     * number of columns of embedded Sobol base matrix.
+     */
+    extern const uint32_t embedded_sobol_s;
+
+    /**
+     * number of rows of embedded Sobol base matrix.
+     */
+    extern const uint32_t embedded_sobol_m;
+
+    /**
+     * Sobol base matrix, embedded_sobol_base[i * embedded_sobol_s + j]
+     * is i-th row and j-th column. Sobol base matrix for smaller s and
+     * m is the upper left part of this.
+     */
+    extern const uint64_t embedded_sobol_base[];
+
+    /**
+     * 32-bit and 64-bit digital nets in database, sorted by id,
+     * bitsize, s and m.
+     */
+    extern const embedded_net_t embedded_nets[];
+    extern const size_t embedded_nets_size;
+
+    /**
+     * ids of which all nets in database are embedded, s and m ranges
+     * of them can be answered from embedded_nets.
+     */
+    extern const int embedded_complete_ids[];
+    extern const size_t embedded_complete_ids_size;
+}
+#endif // EMBEDDED_DATA_H
@@ -2,7 +2,6 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
-#include <sstream>
 #include <cstdio>
 #include <cerrno>
 #include <cstring>
@@ -40,54 +39,40 @@ namespace {
 }
 
 namespace MCQMCIntegration {
-    bool get_interlaced_sobol_base(std::istream& is,
-                                   uint32_t s, uint32_t m,  uint64_t base[])
+    InterlacedSobolColumnReader::InterlacedSobolColumnReader(uint32_t s,
+                                                             uint32_t m)
+        : ColumnReader(s, m)
     {
-#if defined(DEBUG)
-        cout << "in get_interlaced_sobol_base" << endl;
-#endif
+        pos = NULL;
+    }
+
+    bool InterlacedSobolColumnReader::open(const std::string& path)
+    {
+        if (!file.open(path)) {
+            return false;
+        }
+        pos = file.begin();
+        return true;
+    }
+
+    bool InterlacedSobolColumnReader::readColumn(uint64_t column[])
+    {
+        // one line per dimension, only first m numbers of a line
+        // are needed.
+        TextScanner scanner(pos, file.end());
         uint64_t tmp;
-        //uint64_t x[m][s];
-        for (unsigned int i = 0; i < s; i++) {
-            string line;
-            if (!is) {
+        for (unsigned int j = 0; j < m; j++) {
+            if (!scanner.next(tmp, j == 0)) {
 #if defined(DEBUG)
-                cout << "not enough is" << endl;
+                cout << "not enough data (i, j) = (" << dec << col << ","
+                     << j << ")" << endl;
 #endif
                 return false;
             }
-            getline(is, line);
-            stringstream ss(line);
-            for (unsigned int j = 0; j < m; j++) {
-#if defined(DEBUG)
-                cout << "(i, j) = (" << dec << i << "," << j << ")" << endl;
-#endif
-                if (!ss) {
-#if defined(DEBUG)
-                    cout << "not enough ss" << endl;
-#endif
-                    return false;
-                }
-                ss >> tmp;
-#if defined(DEBUG)
-                cout << "DEBUG:tmp = " << dec << tmp << endl;
-#endif
-                tmp = bitreverse(tmp);
-                //x[j][i] = tmp;
-                base[j * s + i] = tmp;
-            }
+            column[j] = bitreverse(tmp);
         }
-#if 0
-        int idx = 0;
-        for (int i = 0; i < m; i++) {
-            for (int j = 0; j < s; j++) {
-                base[idx++] = x[i][j];
-            }
-        }
-#endif
-#if defined(DEBUG)
-        cout << "out get_interlaced_sobol_base" << endl;
-#endif
+        scanner.skipLine();
+        pos = scanner.position();
         return true;
     }
 
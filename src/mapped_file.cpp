@@ -0,0 +1,359 @@
+/**
+ * @file mapped_file.cpp
+ *
+ * @brief read only memory mapped file and number tokenizer.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include "mapped_file.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#if defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define MCQMC_HAVE_FROM_CHARS 1
+#endif
+#endif
+
+using namespace std;
+
+namespace {
+    inline bool is_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r'
+            || c == '\f' || c == '\v';
+    }
+
+    inline bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    const char * parse_unsigned(const char * p, const char * last,
+                                uint64_t * x)
+    {
+#if defined(MCQMC_HAVE_FROM_CHARS)
+        std::from_chars_result r = std::from_chars(p, last, *x);
+        if (r.ec != std::errc()) {
+            return NULL;
+        }
+        return r.ptr;
+#else
+        if (p == last || !is_digit(*p)) {
+            return NULL;
+        }
+        uint64_t v = 0;
+        while (p != last && is_digit(*p)) {
+            uint64_t d = static_cast<uint64_t>(*p - '0');
+            // overflow is error, as from_chars
+            if (v > (UINT64_MAX - d) / 10) {
+                return NULL;
+            }
+            v = v * 10 + d;
+            ++p;
+        }
+        *x = v;
+        return p;
+#endif
+    }
+
+    const char * parse_double(const char * p, const char * last, double * x)
+    {
+#if defined(MCQMC_HAVE_FROM_CHARS) && defined(__cpp_lib_to_chars)
+        std::from_chars_result r = std::from_chars(p, last, *x);
+        if (r.ec != std::errc()) {
+            return NULL;
+        }
+        return r.ptr;
+#else
+        const char * q = p;
+        while (q != last && !is_space(*q)) {
+            ++q;
+        }
+        string token(p, q);
+        char * endp;
+        errno = 0;
+        *x = strtod(token.c_str(), &endp);
+        if (endp == token.c_str() || errno == ERANGE) {
+            return NULL;
+        }
+        return p + (endp - token.c_str());
+#endif
+    }
+}
+
+namespace MCQMCIntegration {
+
+    MappedFile::MappedFile()
+    {
+        first = NULL;
+        length = 0;
+        mapped = false;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    void MappedFile::close()
+    {
+#if defined(HAVE_SYS_MMAN_H)
+        if (mapped) {
+            munmap(const_cast<char *>(first), length);
+        }
+#endif
+        first = NULL;
+        length = 0;
+        mapped = false;
+        buffer.clear();
+    }
+
+    void MappedFile::adviseSequential()
+    {
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_SEQUENTIAL)
+        if (mapped) {
+            madvise(const_cast<char *>(first), length, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+#if defined(HAVE_SYS_MMAN_H)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if (st.st_size > 0) {
+            void * p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                ::close(fd);
+                first = static_cast<const char *>(p);
+                length = st.st_size;
+                mapped = true;
+                return true;
+            }
+        }
+        ::close(fd);
+#endif
+        ifstream ifs(path, ios::in | ios::binary);
+        if (!ifs) {
+            return false;
+        }
+        return assign(ifs);
+    }
+
+    bool MappedFile::assign(std::istream& is)
+    {
+        close();
+        ostringstream oss;
+        oss << is.rdbuf();
+        buffer = oss.str();
+        first = buffer.data();
+        length = buffer.size();
+        return true;
+    }
+
+    bool TextScanner::skipSpace(bool crossLine)
+    {
+        while (pos != last && is_space(*pos)) {
+            if (*pos == '\n' && !crossLine) {
+                return false;
+            }
+            ++pos;
+        }
+        return pos != last;
+    }
+
+    bool TextScanner::next(uint64_t& x, bool crossLine)
+    {
+        if (!skipSpace(crossLine)) {
+            return false;
+        }
+        const char * p = pos;
+        if (*p == '+') {
+            ++p;
+        }
+        p = parse_unsigned(p, last, &x);
+        if (p == NULL) {
+            return false;
+        }
+        pos = p;
+        return true;
+    }
+
+    bool TextScanner::next(int64_t& x, bool crossLine)
+    {
+        if (!skipSpace(crossLine)) {
+            return false;
+        }
+        const char * p = pos;
+        bool minus = false;
+        if (*p == '-') {
+            minus = true;
+            ++p;
+        } else if (*p == '+') {
+            ++p;
+        }
+        uint64_t u = 0;
+        p = parse_unsigned(p, last, &u);
+        if (p == NULL) {
+            return false;
+        }
+        x = minus ? -static_cast<int64_t>(u) : static_cast<int64_t>(u);
+        pos = p;
+        return true;
+    }
+
+    bool TextScanner::next(double& x, bool crossLine)
+    {
+        if (!skipSpace(crossLine)) {
+            return false;
+        }
+        const char * p = pos;
+        if (*p == '+') {
+            ++p;
+        }
+        p = parse_double(p, last, &x);
+        if (p == NULL) {
+            return false;
+        }
+        pos = p;
+        return true;
+    }
+
+    void TextScanner::skipLine()
+    {
+        while (pos != last && *pos != '\n') {
+            ++pos;
+        }
+        if (pos != last) {
+            ++pos;
+        }
+    }
+
+    bool TextScanner::atEnd()
+    {
+        return !skipSpace(true);
+    }
+
+    bool StreamScanner::skipSpace(bool crossLine)
+    {
+        if (buf == NULL) {
+            return false;
+        }
+        for (;;) {
+            int c = buf->sgetc();
+            if (c == char_traits<char>::eof()) {
+                return false;
+            }
+            if (!is_space(static_cast<char>(c))) {
+                return true;
+            }
+            if (c == '\n' && !crossLine) {
+                return false;
+            }
+            buf->sbumpc();
+        }
+    }
+
+    /*
+     * take characters in chars, at most max_token characters.
+     */
+    bool StreamScanner::token(const char * chars, string& str)
+    {
+        const size_t max_token = 400;
+        str.clear();
+        for (;;) {
+            int c = buf->sgetc();
+            if (c == char_traits<char>::eof()
+                || strchr(chars, c) == NULL || c == '\0') {
+                break;
+            }
+            if (str.size() == max_token) {
+                return false;
+            }
+            str += static_cast<char>(c);
+            buf->sbumpc();
+        }
+        return !str.empty();
+    }
+
+    bool StreamScanner::next(uint64_t& x, bool crossLine)
+    {
+        string str;
+        if (!skipSpace(crossLine) || !token("+0123456789", str)) {
+            return false;
+        }
+        const char * first = str.data();
+        const char * last = first + str.size();
+        if (*first == '+') {
+            ++first;
+        }
+        return parse_unsigned(first, last, &x) == last;
+    }
+
+    bool StreamScanner::next(int64_t& x, bool crossLine)
+    {
+        string str;
+        if (!skipSpace(crossLine) || !token("+-0123456789", str)) {
+            return false;
+        }
+        const char * first = str.data();
+        const char * last = first + str.size();
+        bool minus = false;
+        if (*first == '-') {
+            minus = true;
+            ++first;
+        } else if (*first == '+') {
+            ++first;
+        }
+        uint64_t u = 0;
+        if (parse_unsigned(first, last, &u) != last) {
+            return false;
+        }
+        x = minus ? -static_cast<int64_t>(u) : static_cast<int64_t>(u);
+        return true;
+    }
+
+    bool StreamScanner::next(double& x, bool crossLine)
+    {
+        string str;
+        if (!skipSpace(crossLine)
+            || !token("+-.0123456789eExXpPaAfFiInNtTyY", str)) {
+            return false;
+        }
+        const char * first = str.data();
+        const char * last = first + str.size();
+        if (*first == '+') {
+            ++first;
+        }
+        return parse_double(first, last, &x) == last;
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+/**
+ * @file mapped_file.h
+ *
+ * @brief read only memory mapped file and number tokenizer.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include <inttypes.h>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+namespace MCQMCIntegration {
+    /**
+     * Read only view of whole file contents.
+     *
+     * The file is mapped by mmap(2) when available, otherwise it is
+     * read into memory.  Contents of an input stream can also be held.
+     */
+    class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+        /**
+         * map file.
+         * @param[in] path path of the file.
+         * @return true if success.
+         */
+        bool open(const std::string& path);
+        /**
+         * read all remaining contents of input stream.
+         * @param[in,out] is input stream.
+         * @return true if success.
+         */
+        bool assign(std::istream& is);
+        void close();
+        /**
+         * tell kernel that contents will be read sequentially.
+         */
+        void adviseSequential();
+        const char * begin() const {
+            return first;
+        }
+        const char * end() const {
+            return first + length;
+        }
+        size_t size() const {
+            return length;
+        }
+    private:
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+        const char * first;
+        size_t length;
+        bool mapped;
+        std::string buffer;
+    };
+
+    /**
+     * Tokenizer of white space separated numbers.
+     *
+     * The scanner never reads beyond the given range, so the range does
+     * not need to be NUL terminated.
+     */
+    class TextScanner {
+    public:
+        TextScanner(const char * first, const char * last) {
+            pos = first;
+            this->last = last;
+        }
+        /**
+         * read next number.
+         * @param[out] x read value.
+         * @param[in] crossLine if false, fails when next token is not
+         * in the current line.
+         * @return true if success.
+         */
+        bool next(uint64_t& x, bool crossLine = true);
+        bool next(int64_t& x, bool crossLine = true);
+        bool next(double& x, bool crossLine = true);
+        /**
+         * skip until the beginning of next line.
+         */
+        void skipLine();
+        /**
+         * @return true if only white spaces remain.
+         */
+        bool atEnd();
+        const char * position() const {
+            return pos;
+        }
+    private:
+        bool skipSpace(bool crossLine);
+        const char * pos;
+        const char * last;
+    };
+
+    /**
+     * Tokenizer of white space separated numbers from input stream.
+     *
+     * Characters are taken from stream buffer one token at a time, and
+     * a character which can not be a part of the number is left in the
+     * stream. So the stream is not read beyond the last number, even if
+     * it is a pipe.
+     */
+    class StreamScanner {
+    public:
+        explicit StreamScanner(std::istream& is) {
+            buf = is.rdbuf();
+        }
+        /**
+         * read next number.
+         * @param[out] x read value.
+         * @param[in] crossLine if false, fails when next token is not
+         * in the current line.
+         * @return true if success.
+         */
+        bool next(uint64_t& x, bool crossLine = true);
+        bool next(int64_t& x, bool crossLine = true);
+        bool next(double& x, bool crossLine = true);
+    private:
+        bool skipSpace(bool crossLine);
+        bool token(const char * chars, std::string& str);
+        std::streambuf * buf;
+    };
+}
+#endif // MAPPED_FILE_H
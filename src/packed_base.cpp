@@ -0,0 +1,251 @@
+/**
+ * @file packed_base.cpp
+ *
+ * @brief bit packed base matrix of digital net.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include "packed_base.h"
+#include "digital.h"
+#include "bit_operator.h"
+#include "byte_order.h"
+#include <cstring>
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    // header is six little endian 64-bit words, 32-bit fields are
+    // paired in a word, lower one first.
+    const size_t header_size = 6 * 8;
+
+    void encode_header(const digital_net_packed_header_t& header,
+                       uint8_t buffer[])
+    {
+        put_le64(buffer, header.magic);
+        put_le64(buffer + 8, header.version
+                 | static_cast<uint64_t>(header.s) << 32);
+        put_le64(buffer + 16, header.m
+                 | static_cast<uint64_t>(header.precision) << 32);
+        put_le64(buffer + 24, static_cast<uint64_t>(header.tvalue));
+        put_le64(buffer + 32, double_bits(header.wafom));
+        put_le64(buffer + 40, header.size);
+    }
+
+    void decode_header(const uint8_t buffer[],
+                       digital_net_packed_header_t * header)
+    {
+        header->magic = get_le64(buffer);
+        uint64_t x = get_le64(buffer + 8);
+        header->version = static_cast<uint32_t>(x);
+        header->s = static_cast<uint32_t>(x >> 32);
+        x = get_le64(buffer + 16);
+        header->m = static_cast<uint32_t>(x);
+        header->precision = static_cast<uint32_t>(x >> 32);
+        header->tvalue = static_cast<int64_t>(get_le64(buffer + 24));
+        header->wafom = bits_double(get_le64(buffer + 32));
+        header->size = get_le64(buffer + 40);
+    }
+
+    /*
+     * size of whole compact format, 0 if header is wrong.
+     */
+    size_t packed_size(const digital_net_packed_header_t& header)
+    {
+        if (header.magic != DIGITAL_PACKED_MAGIC
+            || header.version != DIGITAL_PACKED_VERSION
+            || header.precision < 1 || header.precision > 64
+            || header.size == 0) {
+            return 0;
+        }
+        size_t rows = (2 * static_cast<size_t>(header.m) + 7) / 8 * 8;
+        return header_size + rows + header.size * sizeof(uint64_t);
+    }
+
+    int bitLength(uint64_t x)
+    {
+        int len = 0;
+        while (x != 0) {
+            x >>= 1;
+            len++;
+        }
+        return len;
+    }
+}
+
+namespace MCQMCIntegration {
+
+    PackedBase::PackedBase()
+    {
+        s = 0;
+        m = 0;
+        precision = 64;
+    }
+
+    void PackedBase::setOffset()
+    {
+        offset.resize(m);
+        uint64_t pos = 0;
+        for (uint32_t k = 0; k < m; k++) {
+            offset[k] = pos;
+            pos += static_cast<uint64_t>(width[k]) * s;
+        }
+    }
+
+    void PackedBase::pack(const uint64_t base[], uint32_t s, uint32_t m,
+                          int precision)
+    {
+        this->s = s;
+        this->m = m;
+        this->precision = precision;
+        int low = 64 - precision;
+        shift.assign(m, 0);
+        width.assign(m, 0);
+        for (uint32_t k = 0; k < m; k++) {
+            uint64_t all = 0;
+            for (uint32_t j = 0; j < s; j++) {
+                all |= base[k * s + j] >> low;
+            }
+            if (all == 0) {
+                continue;
+            }
+            int tz = tailingZeroBit(all);
+            shift[k] = static_cast<uint8_t>(tz + low);
+            width[k] = static_cast<uint8_t>(bitLength(all) - tz);
+        }
+        setOffset();
+        uint64_t total = 0;
+        if (m > 0) {
+            total = offset[m - 1] + static_cast<uint64_t>(width[m - 1]) * s;
+        }
+        // one more word for extract()
+        words.assign((total + 63) / 64 + 1, 0);
+        for (uint32_t k = 0; k < m; k++) {
+            int w = width[k];
+            uint64_t pos = offset[k];
+            for (uint32_t j = 0; j < s && w > 0; j++) {
+                uint64_t v = base[k * s + j] >> shift[k];
+                size_t idx = pos >> 6;
+                int sh = pos & 63;
+                words[idx] |= v << sh;
+                if (sh + w > 64) {
+                    words[idx + 1] |= v >> (64 - sh);
+                }
+                pos += w;
+            }
+        }
+    }
+
+    void PackedBase::unpack(uint64_t base[]) const
+    {
+        for (uint32_t k = 0; k < m; k++) {
+            for (uint32_t j = 0; j < s; j++) {
+                base[k * s + j] = get(k, j);
+            }
+        }
+    }
+
+    bool PackedBase::write(std::ostream& os, double wafom,
+                           int64_t tvalue) const
+    {
+        digital_net_packed_header_t header;
+        memset(&header, 0, sizeof(header));
+        header.magic = DIGITAL_PACKED_MAGIC;
+        header.version = DIGITAL_PACKED_VERSION;
+        header.s = s;
+        header.m = m;
+        header.precision = precision;
+        header.tvalue = tvalue;
+        header.wafom = wafom;
+        header.size = words.size();
+        uint8_t buffer[header_size];
+        encode_header(header, buffer);
+        os.write(reinterpret_cast<const char *>(buffer), header_size);
+        vector<uint8_t> rows((2 * m + 7) / 8 * 8, 0);
+        for (uint32_t k = 0; k < m; k++) {
+            rows[2 * k] = shift[k];
+            rows[2 * k + 1] = width[k];
+        }
+        os.write(reinterpret_cast<const char *>(&rows[0]), rows.size());
+        for (size_t i = 0; i < words.size(); i++) {
+            write_le64(os, words[i]);
+        }
+        return static_cast<bool>(os);
+    }
+
+    size_t PackedBase::read(const char * first, const char * last,
+                            double * wafom, int64_t * tvalue)
+    {
+        digital_net_packed_header_t header;
+        size_t avail = last - first;
+        if (avail < header_size) {
+            return 0;
+        }
+        decode_header(reinterpret_cast<const uint8_t *>(first), &header);
+        size_t size = packed_size(header);
+        if (size == 0 || avail < size) {
+            return 0;
+        }
+        size_t rows = (2 * static_cast<size_t>(header.m) + 7) / 8 * 8;
+        s = header.s;
+        m = header.m;
+        precision = header.precision;
+        shift.resize(m);
+        width.resize(m);
+        const char * p = first + header_size;
+        for (uint32_t k = 0; k < m; k++) {
+            shift[k] = static_cast<uint8_t>(p[2 * k]);
+            width[k] = static_cast<uint8_t>(p[2 * k + 1]);
+            if (width[k] > 64 || shift[k] > 63) {
+                return 0;
+            }
+        }
+        setOffset();
+        uint64_t total = 0;
+        if (m > 0) {
+            total = offset[m - 1] + static_cast<uint64_t>(width[m - 1]) * s;
+        }
+        if ((total + 63) / 64 + 1 > header.size) {
+            return 0;
+        }
+        words.resize(header.size);
+        const uint8_t * q = reinterpret_cast<const uint8_t *>(p + rows);
+        for (size_t i = 0; i < words.size(); i++) {
+            words[i] = get_le64(q + i * 8);
+        }
+        *wafom = header.wafom;
+        *tvalue = header.tvalue;
+        return size;
+    }
+
+    bool PackedBase::read(std::istream& is, double * wafom, int64_t * tvalue)
+    {
+        digital_net_packed_header_t header;
+        vector<char> buffer(header_size);
+        if (!is.read(&buffer[0], buffer.size())) {
+            return false;
+        }
+        decode_header(reinterpret_cast<const uint8_t *>(&buffer[0]),
+                      &header);
+        size_t size = packed_size(header);
+        if (size == 0) {
+            return false;
+        }
+        buffer.resize(size);
+        if (!is.read(&buffer[header_size], size - header_size)) {
+            return false;
+        }
+        return read(&buffer[0], &buffer[0] + size, wafom, tvalue) == size;
+    }
+}
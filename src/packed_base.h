@@ -0,0 +1,156 @@
+#pragma once
+#ifndef PACKED_BASE_H
+#define PACKED_BASE_H
+/**
+ * @file packed_base.h
+ *
+ * @brief bit packed base matrix of digital net.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <inttypes.h>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace MCQMCIntegration {
+    /**
+     * Base matrix whose rows are bit packed.
+     *
+     * Only upper @b precision bits of each element are kept. Moreover,
+     * leading zeros and trailing zeros common to a row are removed, for
+     * example, k-th row of Sobol base matrix has only k + 1 significant
+     * bits.
+     */
+    class PackedBase {
+    public:
+        PackedBase();
+        /**
+         * pack base matrix.
+         * @param[in] base base matrix, base[k * s + j].
+         * @param[in] s number of columns.
+         * @param[in] m number of rows.
+         * @param[in] precision number of upper bits kept, 1 <= precision
+         * <= 64.
+         */
+        void pack(const uint64_t base[], uint32_t s, uint32_t m,
+                  int precision);
+
+        /**
+         * unpack whole base matrix.
+         * @param[out] base base matrix, base[k * s + j].
+         */
+        void unpack(uint64_t base[]) const;
+
+        /**
+         * get an element.
+         * @param[in] k row
+         * @param[in] j column
+         * @return element of base matrix.
+         */
+        uint64_t get(uint32_t k, uint32_t j) const {
+            return extract(offset[k] + static_cast<uint64_t>(j) * width[k],
+                           width[k]) << shift[k];
+        }
+
+        /**
+         * xor k-th row to @b x, x[j] ^= get(k, j) for 0 <= j < n.
+         * @param[in] k row
+         * @param[in,out] x destination.
+         * @param[in] n number of columns.
+         */
+        void xorRow(uint32_t k, uint64_t x[], uint32_t n) const {
+            int w = width[k];
+            if (w == 0) {
+                return;
+            }
+            int sh = shift[k];
+            uint64_t pos = offset[k];
+            for (uint32_t j = 0; j < n; j++) {
+                x[j] ^= extract(pos, w) << sh;
+                pos += w;
+            }
+        }
+
+        int getPrecision() const {
+            return precision;
+        }
+
+        /**
+         * @return memory size of packed data in bytes.
+         */
+        size_t byteSize() const {
+            return words.size() * sizeof(uint64_t)
+                + offset.size() * sizeof(uint64_t) + m * 2;
+        }
+
+        /**
+         * write in compact binary format.
+         * @param[in,out] os output stream
+         * @param[in] wafom WAFOM value
+         * @param[in] tvalue t-value
+         * @return true if success.
+         */
+        bool write(std::ostream& os, double wafom, int64_t tvalue) const;
+
+        /**
+         * read compact binary format from memory.
+         * @param[in] first beginning of data
+         * @param[in] last end of data
+         * @param[out] wafom WAFOM value
+         * @param[out] tvalue t-value
+         * @return number of bytes read, 0 if fail.
+         */
+        size_t read(const char * first, const char * last,
+                    double * wafom, int64_t * tvalue);
+
+        /**
+         * read compact binary format from input stream. Data after the
+         * compact format are left in the stream.
+         * @param[in,out] is input stream
+         * @param[out] wafom WAFOM value
+         * @param[out] tvalue t-value
+         * @return true if success.
+         */
+        bool read(std::istream& is, double * wafom, int64_t * tvalue);
+
+        uint32_t getS() const {
+            return s;
+        }
+
+        uint32_t getM() const {
+            return m;
+        }
+    private:
+        uint64_t extract(uint64_t pos, int w) const {
+            size_t idx = pos >> 6;
+            int sh = pos & 63;
+            uint64_t v = words[idx] >> sh;
+            if (sh + w > 64) {
+                v |= words[idx + 1] << (64 - sh);
+            }
+            if (w < 64) {
+                v &= (UINT64_C(1) << w) - 1;
+            }
+            return v;
+        }
+        void setOffset();
+        uint32_t s;
+        uint32_t m;
+        int precision;
+        std::vector<uint8_t> shift;
+        std::vector<uint8_t> width;
+        std::vector<uint64_t> offset;
+        std::vector<uint64_t> words;
+    };
+}
+#endif // PACKED_BASE_H
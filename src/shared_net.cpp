@@ -0,0 +1,295 @@
+/**
+ * @file shared_net.cpp
+ *
+ * @brief POSIX shared memory cache of base matrix.
+ *
+ * A segment is named by user, version, id, bit size, s and m. The data
+ * segment itself is locked by flock(2): readers attach under a shared
+ * lock, and a writer holds an exclusive lock while it fills the segment,
+ * so that a segment is either complete or empty for readers. A segment
+ * left incomplete by a crashed process, or written by other version, is
+ * removed and published again.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "config.h"
+#include "digital.h"
+#include "shared_net.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <atomic>
+#if defined(HAVE_SHM_OPEN) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define MCQMC_USE_SHM 1
+#endif
+
+using namespace std;
+
+namespace {
+    using namespace MCQMCIntegration;
+
+    const char * shared_cache_env = "DIGITAL_NET_SHM";
+
+    int initial_state()
+    {
+        const char * env = getenv(shared_cache_env);
+        if (env != NULL && env[0] != '\0' && env[0] != '0') {
+            return 1;
+        }
+        return 0;
+    }
+
+    atomic<int> shared_cache_state(initial_state());
+
+#if defined(MCQMC_USE_SHM)
+    const string segmentName(DigitalNetID id, uint32_t s, uint32_t m)
+    {
+        stringstream ss;
+        ss << "/mcqmcint." << getuid() << ".v" << DIGITAL_SHARED_VERSION
+           << "." << static_cast<int>(id) << ".64." << s << "." << m;
+        return ss.str();
+    }
+
+    /*
+     * unmap whole segment when base matrix is released.
+     */
+    class SegmentRelease {
+    public:
+        SegmentRelease(void * addr, size_t length) {
+            this->addr = addr;
+            this->length = length;
+        }
+        void operator()(uint64_t *) {
+            munmap(addr, length);
+        }
+    private:
+        void * addr;
+        size_t length;
+    };
+
+    bool valid(const digital_net_shared_header_t * header,
+               DigitalNetID id, uint32_t s, uint32_t m)
+    {
+        return header->magic == DIGITAL_SHARED_MAGIC
+            && header->version == DIGITAL_SHARED_VERSION
+            && header->ready == 1
+            && header->id == static_cast<uint32_t>(id)
+            && header->bit == 64
+            && header->s == s
+            && header->m == m;
+    }
+
+    /*
+     * map segment of valid base matrix, should be called with lock.
+     * @return true if attached.
+     */
+    bool attach(int fd, DigitalNetID id, uint32_t s, uint32_t m,
+                size_t length, shared_ptr<uint64_t> * base,
+                int64_t * tvalue, double * wafom)
+    {
+        void * addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        const digital_net_shared_header_t * header
+            = static_cast<const digital_net_shared_header_t *>(addr);
+        if (!valid(header, id, s, m)) {
+            munmap(addr, length);
+            return false;
+        }
+        *tvalue = header->tvalue;
+        *wafom = header->wafom;
+        uint64_t * data = reinterpret_cast<uint64_t *>(
+            static_cast<char *>(addr) + DIGITAL_SHARED_OFFSET);
+        base->reset(data, SegmentRelease(addr, length));
+        return true;
+    }
+
+    /*
+     * load base matrix into empty segment, should be called with lock.
+     * @return 0 if success, shared_base_unavailable if can't map,
+     * otherwise error of loader.
+     */
+    int publish(int fd, DigitalNetID id, uint32_t s, uint32_t m,
+                size_t length, base_loader_t loader,
+                shared_ptr<uint64_t> * base,
+                int64_t * tvalue, double * wafom)
+    {
+        if (ftruncate(fd, length) != 0) {
+            return shared_base_unavailable;
+        }
+        void * addr = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            return shared_base_unavailable;
+        }
+        digital_net_shared_header_t * header
+            = static_cast<digital_net_shared_header_t *>(addr);
+        uint64_t * data = reinterpret_cast<uint64_t *>(
+            static_cast<char *>(addr) + DIGITAL_SHARED_OFFSET);
+        int r = loader(id, s, m, data, tvalue, wafom);
+        if (r != 0) {
+            munmap(addr, length);
+            return r;
+        }
+        header->magic = DIGITAL_SHARED_MAGIC;
+        header->version = DIGITAL_SHARED_VERSION;
+        header->id = static_cast<uint32_t>(id);
+        header->bit = 64;
+        header->s = s;
+        header->m = m;
+        header->tvalue = *tvalue;
+        header->wafom = *wafom;
+        header->ready = 1;
+        mprotect(addr, length, PROT_READ);
+        base->reset(data, SegmentRelease(addr, length));
+        return 0;
+    }
+
+    /*
+     * check @b fd is still the segment of @b name, which may be removed
+     * and created again while waiting for lock.
+     */
+    bool current(int fd, const string& name)
+    {
+        int now = shm_open(name.c_str(), O_RDONLY, 0);
+        if (now < 0) {
+            return false;
+        }
+        struct stat a;
+        struct stat b;
+        bool same = fstat(fd, &a) == 0 && fstat(now, &b) == 0
+            && a.st_dev == b.st_dev && a.st_ino == b.st_ino;
+        close(now);
+        return same;
+    }
+#endif
+}
+
+namespace MCQMCIntegration {
+
+    void setSharedMemoryCache(bool enable)
+    {
+        shared_cache_state = enable ? 1 : 0;
+    }
+
+    bool getSharedMemoryCache()
+    {
+        return shared_cache_state != 0;
+    }
+
+    bool removeSharedMemoryCache(DigitalNetID id, uint32_t s, uint32_t m)
+    {
+#if defined(MCQMC_USE_SHM)
+        string name = segmentName(id, s, m);
+        return shm_unlink(name.c_str()) == 0;
+#else
+        (void)id;
+        (void)s;
+        (void)m;
+        return false;
+#endif
+    }
+
+    int get_shared_base(DigitalNetID id, uint32_t s, uint32_t m,
+                        base_loader_t loader,
+                        std::shared_ptr<uint64_t> * base,
+                        int64_t * tvalue, double * wafom)
+    {
+#if defined(MCQMC_USE_SHM)
+        string name = segmentName(id, s, m);
+        size_t length = DIGITAL_SHARED_OFFSET
+            + static_cast<size_t>(s) * m * sizeof(uint64_t);
+        // segment itself is locked. A complete segment is attached under
+        // a shared lock, exclusive lock is taken only by a process which
+        // finds it empty or broken, and loads base matrix.
+        for (int retry = 0; retry < 3; retry++) {
+            int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+            if (fd < 0) {
+                return shared_base_unavailable;
+            }
+            if (flock(fd, LOCK_SH) != 0) {
+                close(fd);
+                return shared_base_unavailable;
+            }
+            if (!current(fd, name)) {
+                close(fd);
+                continue;
+            }
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                return shared_base_unavailable;
+            }
+            if (static_cast<size_t>(st.st_size) == length
+                && attach(fd, id, s, m, length, base, tvalue, wafom)) {
+                flock(fd, LOCK_UN);
+                close(fd);
+                return 0;
+            }
+            // conversion of lock is not atomic, segment may be changed
+            // by other process meanwhile
+            if (flock(fd, LOCK_EX) != 0) {
+                close(fd);
+                return shared_base_unavailable;
+            }
+            if (!current(fd, name)) {
+                close(fd);
+                continue;
+            }
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                return shared_base_unavailable;
+            }
+            int r;
+            if (st.st_size == 0) {
+                r = publish(fd, id, s, m, length, loader, base,
+                            tvalue, wafom);
+                if (r != 0) {
+                    shm_unlink(name.c_str());
+                }
+            } else if (static_cast<size_t>(st.st_size) == length
+                       && attach(fd, id, s, m, length, base,
+                                 tvalue, wafom)) {
+                r = 0;
+            } else {
+                // incomplete or old segment, made again
+                shm_unlink(name.c_str());
+                flock(fd, LOCK_UN);
+                close(fd);
+                continue;
+            }
+            // mapping keeps open file description, so lock is released
+            // explicitly
+            flock(fd, LOCK_UN);
+            close(fd);
+            return r;
+        }
+        return shared_base_unavailable;
+#else
+        (void)id;
+        (void)s;
+        (void)m;
+        (void)loader;
+        (void)base;
+        (void)tvalue;
+        (void)wafom;
+        return shared_base_unavailable;
+#endif
+    }
+}
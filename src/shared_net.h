@@ -0,0 +1,56 @@
+#pragma once
+#ifndef SHARED_NET_H
+#define SHARED_NET_H
+/**
+ * @file shared_net.h
+ *
+ * @brief POSIX shared memory cache of base matrix.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <MCQMCIntegration/DigitalNet.h>
+#include <inttypes.h>
+#include <memory>
+
+namespace MCQMCIntegration {
+    /**
+     * get_shared_base() returns this when shared memory can't be used,
+     * which is not an error code of loaders.
+     */
+    const int shared_base_unavailable = -2;
+
+    /**
+     * function which reads base matrix of pre-defined digital net.
+     */
+    typedef int (*base_loader_t)(DigitalNetID id, uint32_t s, uint32_t m,
+                                 uint64_t base[],
+                                 int64_t * tvalue, double * wafom);
+
+    /**
+     * get base matrix from shared memory segment, or load and publish it
+     * when the segment does not exist.
+     * @param[in] id ID of pre-defined digital net.
+     * @param[in] s dimension of point set.
+     * @param[in] m F2 dimension of element of point set.
+     * @param[in] loader function to load base matrix.
+     * @param[out] base read only base matrix in shared memory.
+     * @param[out] tvalue t-value.
+     * @param[out] wafom WAFOM value.
+     * @return 0 if success, shared_base_unavailable if shared memory
+     * is not available, otherwise error code of loader.
+     */
+    int get_shared_base(DigitalNetID id, uint32_t s, uint32_t m,
+                        base_loader_t loader,
+                        std::shared_ptr<uint64_t> * base,
+                        int64_t * tvalue, double * wafom);
+}
+#endif // SHARED_NET_H
@@ -76,40 +76,78 @@ using namespace std;
 static const int max_data = 50;
 
 namespace {
-    bool read_data(istream& is, uint32_t data[]);
+    bool read_data(const char ** pos, const char * last, uint32_t data[]);
 }
 
 namespace MCQMCIntegration {
 
-    bool get_sobol_base(std::istream& is,
-                        uint32_t s, uint32_t m,  uint64_t base[])
+    template<typename U>
+    bool ColumnReader::readColumns(uint32_t last, U base[])
     {
-        uint32_t D = s + 1;
-        uint32_t L = m;
-        //uint32_t N = UINT32_C(1) << (m - 1);
-        uint32_t col = 0;
-        uint64_t V[L + 1];
-        for (unsigned i=1;i<=L;i++) {
-            V[i] = UINT64_C(1) << (64 - i); // all m's = 1
+        for (; col < last; col++) {
+            if (!readColumn(&column[0])) {
+                return false;
+            }
+            for (uint32_t i = 0; i < m; i++) {
+                if (sizeof(U) * 8 == 32) {
+                    base[i * s + col] = static_cast<U>(column[i] >> 32);
+                } else {
+                    base[i * s + col] = static_cast<U>(column[i]);
+                }
+            }
         }
-#if defined(DEBUG)
-        cout << "col = " << dec << col << endl;
-        for (uint32_t i = 1; i <= L; i++) {
-            cout << "V[" << dec << i << "] = " << hex << V[i] << endl;
+        return true;
+    }
+
+    bool ColumnReader::read(uint32_t last, uint64_t base[])
+    {
+        return readColumns(last, base);
+    }
+
+    bool ColumnReader::read(uint32_t last, uint32_t base[])
+    {
+        return readColumns(last, base);
+    }
+
+    SobolColumnReader::SobolColumnReader(uint32_t s, uint32_t m)
+        : ColumnReader(s, m), V(m + 1)
+    {
+        pos = NULL;
+    }
+
+    bool SobolColumnReader::open(const std::string& path)
+    {
+        if (!file.open(path)) {
+            return false;
         }
-#endif
-        for (uint32_t i = 1; i <= L; i++) {
-            base[(i - 1) * s + col] = V[i];
+        pos = file.begin();
+        return true;
+    }
+
+    bool SobolColumnReader::assign(std::istream& is)
+    {
+        if (!file.assign(is)) {
+            return false;
         }
+        pos = file.begin();
+        return true;
+    }
+
+    bool SobolColumnReader::readColumn(uint64_t column[])
+    {
+        uint32_t L = m;
         uint32_t data[max_data];
-        for (uint32_t c = 1; c < D - 1; c++) {
-            bool success = read_data(is, data);
+        if (col == 0) {
+            for (unsigned i=1;i<=L;i++) {
+                V[i] = UINT64_C(1) << (64 - i); // all m's = 1
+            }
+        } else {
+            bool success = read_data(&pos, file.end(), data);
             if (! success) {
                 cerr << "data format error" << endl;
                 //throw runtime_error("data format error");
                 return false;
             }
-            col++;
             //uint32_t d_sobol = data[0];
             uint32_t s_sobol = data[1];
             uint32_t a_sobol = data[2];
@@ -131,28 +169,36 @@ namespace MCQMCIntegration {
                 for (unsigned i = s_sobol + 1; i <= L; i++) {
                     V[i] = V[i - s_sobol] ^ (V[i - s_sobol] >> s_sobol);
                     for (unsigned k=1; k <= s_sobol-1; k++) {
-                        V[i] ^= (((a_sobol >> (s_sobol-1-k)) & 1) * V[i-k]);
+                        V[i] ^= (((a_sobol >> (s_sobol-1-k)) & 1)
+                                 * V[i-k]);
                     }
                 }
             }
+        }
 #if defined(DEBUG)
-            cout << "col = " << dec << col << endl;
-            for (uint32_t i = 1; i <= L; i++) {
-                cout << "V[" << dec << i << "] = " << hex << V[i] << endl;
-            }
-#endif
-            for (uint32_t i = 1; i <= L; i++) {
-                base[(i - 1) * s + col] = V[i];
-            }
+        cout << "col = " << dec << col << endl;
+        for (uint32_t i = 1; i <= L; i++) {
+            cout << "V[" << dec << i << "] = " << hex << V[i] << endl;
         }
-        for (uint32_t i = L - 1; i >= 1; i--) {
-            for (uint32_t j = 0; j < s; j++) {
-                base[i * s + j] ^= base[(i - 1) * s + j];
-            }
+#endif
+        // base for gray code order
+        column[0] = V[1];
+        for (uint32_t i = 2; i <= L; i++) {
+            column[i - 1] = V[i] ^ V[i - 1];
         }
         return true;
     }
 
+    bool get_sobol_base(std::istream& is,
+                        uint32_t s, uint32_t m,  uint64_t base[])
+    {
+        SobolColumnReader reader(s, m);
+        if (!reader.assign(is)) {
+            return false;
+        }
+        return reader.read(s, base);
+    }
+
     int get_sobol_s_max() {
         return 21201;
     }
@@ -175,17 +221,22 @@ namespace MCQMCIntegration {
 }
 
 namespace {
-    bool read_data(istream& is, uint32_t data[])
+    bool read_data(const char ** pos, const char * last, uint32_t data[])
     {
-        is.read(reinterpret_cast<char *>(data), sizeof(uint32_t) * 3);
-        if (!is) {
+        const size_t head = sizeof(uint32_t) * 3;
+        if (static_cast<size_t>(last - *pos) < head) {
             return false;
         }
-        is.read(reinterpret_cast<char *>(&data[3]), sizeof(uint32_t) * data[1]);
-        if (!is) {
+        memcpy(data, *pos, head);
+        if (data[1] > static_cast<uint32_t>(max_data - 3)) {
             return false;
-        } else {
-            return true;
         }
+        size_t size = sizeof(uint32_t) * data[1];
+        if (static_cast<size_t>(last - *pos) < head + size) {
+            return false;
+        }
+        memcpy(&data[3], *pos + head, size);
+        *pos += head + size;
+        return true;
     }
 }
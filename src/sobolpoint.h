@@ -3,13 +3,100 @@
 #define SOBOL_POINT_H
 
 #include <iostream>
+#include <string>
+#include <vector>
 #include <inttypes.h>
+#include "mapped_file.h"
 
 namespace MCQMCIntegration {
+    /**
+     * Reader of base matrix column by column, i.e. dimension by dimension.
+     *
+     * Columns are read in increasing order, so that the first columns
+     * of a large base matrix can be made without reading the rest of
+     * data file.
+     */
+    class ColumnReader {
+    public:
+        virtual ~ColumnReader() {}
+        /**
+         * read columns from next() to @b last - 1, and write them
+         * directly into @b base.
+         * @param[in] last end of columns to be read, must be <= s.
+         * @param[out] base base matrix, base[i * s + j] is i-th row and
+         * j-th column.
+         * @return true if success.
+         */
+        bool read(uint32_t last, uint64_t base[]);
+
+        /**
+         * read columns, upper 32 bits of elements are written into
+         * @b base.
+         * @param[in] last end of columns to be read, must be <= s.
+         * @param[out] base base matrix, base[i * s + j] is i-th row and
+         * j-th column.
+         * @return true if success.
+         */
+        bool read(uint32_t last, uint32_t base[]);
+
+        /**
+         * @return the first column which is not read yet.
+         */
+        uint32_t next() const {
+            return col;
+        }
+    protected:
+        ColumnReader(uint32_t s, uint32_t m) : column(m) {
+            this->s = s;
+            this->m = m;
+            col = 0;
+        }
+        /**
+         * read column next().
+         * @param[out] column m elements of the column.
+         * @return true if success.
+         */
+        virtual bool readColumn(uint64_t column[]) = 0;
+        MappedFile file;
+        uint32_t s;
+        uint32_t m;
+        uint32_t col;
+    private:
+        template<typename U>
+        bool readColumns(uint32_t last, U base[]);
+        std::vector<uint64_t> column;
+    };
+
+    /**
+     * Column reader of Sobol point set from direction numbers file.
+     */
+    class SobolColumnReader : public ColumnReader {
+    public:
+        SobolColumnReader(uint32_t s, uint32_t m);
+        bool open(const std::string& path);
+        bool assign(std::istream& is);
+    protected:
+        bool readColumn(uint64_t column[]);
+    private:
+        const char * pos;
+        std::vector<uint64_t> V;
+    };
+
+    /**
+     * Column reader of Interlaced Sobol point set from .col file.
+     */
+    class InterlacedSobolColumnReader : public ColumnReader {
+    public:
+        InterlacedSobolColumnReader(uint32_t s, uint32_t m);
+        bool open(const std::string& path);
+    protected:
+        bool readColumn(uint64_t column[]);
+    private:
+        const char * pos;
+    };
+
     bool get_sobol_base(std::istream& is,
                         uint32_t s, uint32_t m,  uint64_t base[]);
-    bool get_interlaced_sobol_base(std::istream& is,
-                                   uint32_t s, uint32_t m,  uint64_t base[]);
     int get_sobol_s_max();
     int get_sobol_s_min();
     int get_sobol_m_max();
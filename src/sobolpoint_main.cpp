@@ -6,6 +6,7 @@
 #include <cerrno>
 #include <cstring>
 #include <stdexcept>
+#include <vector>
 #include "sobolpoint.h"
 
 using namespace std;
@@ -37,8 +38,8 @@ int main(int argc, char * argv[])
         cout << "can't open " << datafile << endl;
         return -1;
     }
-    uint64_t data[s * m];
-    bool success = get_sobol_base(ifs, s, m, data);
+    vector<uint64_t> data(static_cast<size_t>(s) * m);
+    bool success = get_sobol_base(ifs, s, m, &data[0]);
     ifs.close();
     if (! success) {
         return -1;
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    void print(const MCQMCAdaptiveResult& r)
+    {
+        cout << setprecision(17);
+        cout << "value = " << r.value << " error = " << r.error
+             << " N = " << r.N << " m = " << r.m
+             << " evaluations = " << r.evaluations
+             << " converged = " << r.converged << endl;
+    }
+
+    int test_converge()
+    {
+        Integrand integrand(4);
+        MCQMCTolerance tolerance(1e-7);
+        MCQMCAdaptiveResult r = adaptive_quasi_monte_carlo_integration(
+            integrand, SOBOL, 4, tolerance);
+        if (!r.converged || r.error > 1e-7 || fabs(r.value - 1.0) > 1e-6) {
+            cout << "converge" << endl;
+            print(r);
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_budget()
+    {
+        Integrand integrand(4);
+        MCQMCTolerance tolerance(1e-300);
+        tolerance.maxEvaluations = 100000;
+        MCQMCAdaptiveResult r = adaptive_quasi_monte_carlo_integration(
+            integrand, SOBOL, 4, tolerance);
+        if (r.converged || r.evaluations > tolerance.maxEvaluations) {
+            cout << "budget" << endl;
+            print(r);
+            return -1;
+        }
+        return 0;
+    }
+
+    /*
+     * the first evaluation is in the budget.
+     */
+    int test_first_budget()
+    {
+        Integrand integrand(4);
+        MCQMCTolerance tolerance(1e-300);
+        tolerance.minM = 10;
+        tolerance.maxM = 10;
+        tolerance.minTrials = 8;
+        tolerance.maxEvaluations = 3 << 10;
+        MCQMCAdaptiveResult r = adaptive_quasi_monte_carlo_integration(
+            integrand, SOBOL, 4, tolerance);
+        if (r.N != 3 || r.evaluations != tolerance.maxEvaluations) {
+            cout << "first budget" << endl;
+            print(r);
+            return -1;
+        }
+        tolerance.maxEvaluations = 1 << 10;
+        try {
+            adaptive_quasi_monte_carlo_integration(integrand, SOBOL, 4,
+                                                   tolerance);
+            cout << "no exception for too small budget" << endl;
+            return -1;
+        } catch (const char *) {
+        }
+        return 0;
+    }
+
+    /*
+     * points reused after increase of m give the same result as
+     * evaluation of the final point set from the beginning.
+     */
+    int test_reuse()
+    {
+        uint32_t s = 5;
+        Integrand integrand(s);
+        MCQMCTolerance tolerance(1e-300);
+        tolerance.minM = 8;
+        tolerance.maxM = 11;
+        tolerance.minTrials = 4;
+        // no room for more randomizations
+        tolerance.maxEvaluations = (4 << 11) + 100;
+        MCQMCAdaptiveResult r = adaptive_quasi_monte_carlo_integration(
+            integrand, SOBOL, s, tolerance);
+        if (r.m != 11 || r.N != 4
+            || r.evaluations != static_cast<uint64_t>(4) << 11) {
+            cout << "reuse" << endl;
+            print(r);
+            return -1;
+        }
+        DigitalNet<uint64_t> net(SOBOL, s, r.m);
+        std::mt19937_64 mt(tolerance.seed);
+        BatchFeeder<Integrand> feeder(integrand, s);
+        std::vector<uint64_t> shift(s);
+        OnlineVariance var;
+        for (uint32_t i = 0; i < r.N; i++) {
+            for (uint32_t j = 0; j < s; j++) {
+                shift[j] = mt();
+            }
+            double sum = qmc_partial_sum(feeder, net, &shift[0], 0,
+                                         UINT64_C(1) << r.m);
+            var.addData(sum / (1 << r.m));
+        }
+        if (fabs(var.getMean() - r.value) > 1e-14) {
+            cout << "reuse" << endl;
+            print(r);
+            cout << "expected = " << var.getMean() << endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_converge() != 0
+        || test_budget() != 0
+        || test_first_budget() != 0
+        || test_reuse() != 0) {
+        return -1;
+    }
+    return 0;
+}
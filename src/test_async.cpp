@@ -0,0 +1,206 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <MCQMCIntegration/AsyncIntegrand.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    /*
+     * external simulator, workers reply after latency, which differs by
+     * index so that replies are out of order.
+     */
+    class Simulator {
+    public:
+        Simulator(int s, int workers, int latency,
+                  uint64_t failAt = UINT64_MAX) {
+            this->s = s;
+            this->latency = latency;
+            this->failAt = failAt;
+            inFlight = 0;
+            maxInFlight = 0;
+            stopped = false;
+            for (int i = 0; i < workers; i++) {
+                threads.push_back(thread([this]() { work(); }));
+            }
+        }
+        ~Simulator() {
+            {
+                unique_lock<mutex> lock(mtx);
+                stopped = true;
+                cond.notify_all();
+            }
+            for (size_t i = 0; i < threads.size(); i++) {
+                threads[i].join();
+            }
+        }
+        void operator()(uint64_t index, const double p[],
+                        AsyncCompletion& completion) {
+            unique_lock<mutex> lock(mtx);
+            inFlight++;
+            if (inFlight > maxInFlight) {
+                maxInFlight = inFlight;
+            }
+            Request r = {index, p, &completion};
+            requests.push_back(r);
+            cond.notify_one();
+        }
+        size_t maxInFlight;
+    private:
+        struct Request {
+            uint64_t index;
+            const double * p;
+            AsyncCompletion * completion;
+        };
+        void work() {
+            for (;;) {
+                Request r;
+                {
+                    unique_lock<mutex> lock(mtx);
+                    while (!stopped && requests.empty()) {
+                        cond.wait(lock);
+                    }
+                    if (requests.empty()) {
+                        return;
+                    }
+                    r = requests.front();
+                    requests.pop_front();
+                }
+                int wait = latency * static_cast<int>(1 + r.index * 7 % 5);
+                this_thread::sleep_for(chrono::microseconds(wait));
+                double x = integrand_value(r.p, s);
+                {
+                    unique_lock<mutex> lock(mtx);
+                    inFlight--;
+                }
+                if (r.index == failAt) {
+                    r.completion->fail(r.index, make_exception_ptr(
+                                           runtime_error("simulator")));
+                } else {
+                    r.completion->done(r.index, x);
+                }
+            }
+        }
+        int s;
+        int latency;
+        uint64_t failAt;
+        size_t inFlight;
+        bool stopped;
+        mutex mtx;
+        condition_variable cond;
+        deque<Request> requests;
+        vector<thread> threads;
+    };
+
+    /*
+     * completes in operator()
+     */
+    class Immediate {
+    public:
+        Immediate(int s) {
+            this->s = s;
+        }
+        void operator()(uint64_t index, const double p[],
+                        AsyncCompletion& completion) {
+            completion.done(index, integrand_value(p, s));
+        }
+    private:
+        int s;
+    };
+
+    MCQMCResult expected(uint32_t s, uint32_t m, uint32_t N)
+    {
+        Integrand integrand(s);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        return quasi_monte_carlo_integration(N, integrand, net);
+    }
+
+    int test_same(uint32_t s, uint32_t m, uint32_t N, size_t depth)
+    {
+        MCQMCResult expect = expected(s, m, N);
+        Simulator simulator(s, 8, 5);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        MCQMCResult result = async_quasi_monte_carlo_integration(
+            N, simulator, net, depth);
+        if (!same(result, expect) || simulator.maxInFlight > depth) {
+            cout << "depth = " << depth << setprecision(17) << endl;
+            cout << "result = " << result.value << " "
+                 << result.error << endl;
+            cout << "expected = " << expect.value << " "
+                 << expect.error << endl;
+            cout << "max in flight = " << simulator.maxInFlight << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_immediate()
+    {
+        MCQMCResult expect = expected(5, 10, 3);
+        Immediate immediate(5);
+        DigitalNet<uint64_t> net(SOBOL, 5, 10);
+        MCQMCResult result = async_quasi_monte_carlo_integration(
+            3, immediate, net, 4);
+        if (!same(result, expect)) {
+            cout << "immediate" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_failure()
+    {
+        Simulator simulator(4, 4, 5, 100);
+        DigitalNet<uint64_t> net(SOBOL, 4, 8);
+        try {
+            async_quasi_monte_carlo_integration(3, simulator, net, 16);
+        } catch (const runtime_error&) {
+            return 0;
+        }
+        cout << "failure is not reported" << endl;
+        return -1;
+    }
+
+    double seconds(size_t depth)
+    {
+        Simulator simulator(4, 16, 200);
+        DigitalNet<uint64_t> net(SOBOL, 4, 6);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        async_quasi_monte_carlo_integration(2, simulator, net, depth);
+        chrono::duration<double> d = chrono::steady_clock::now() - start;
+        return d.count();
+    }
+
+    int test_throughput()
+    {
+        // latency bound, 128 points of 600us on average
+        double serial = seconds(1);
+        double deep = seconds(16);
+        if (deep * 2 > serial) {
+            cout << "depth 1 = " << serial << "s depth 16 = "
+                 << deep << "s" << endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_same(4, 8, 5, 1) != 0
+        || test_same(4, 8, 5, 7) != 0
+        || test_same(6, 10, 3, 64) != 0
+        || test_same(4, 6, 1, 3) != 0
+        || test_immediate() != 0
+        || test_failure() != 0
+        || test_throughput() != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <MCQMCIntegration/AutoSelect.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    int test_target()
+    {
+        const uint32_t s = 5;
+        const uint64_t budget = UINT64_C(1) << 18;
+        Integrand integrand(s);
+        MCQMCTolerance tolerance(1e-6);
+        MCQMCSelection selection = autoSelect(integrand, s, tolerance,
+                                              budget);
+        const MCQMCCandidate& best = selection.best;
+        if (!selection.reachable || selection.candidates.empty()
+            || best.error > 1e-6 || best.N < tolerance.minTrials
+            || best.m < getMMin(best.id, s) || best.m > getMMax(best.id, s)
+            || selection.pilotEvaluations > budget) {
+            cout << "target id = " << best.id << " m = " << best.m
+                 << " N = " << best.N << " error = " << best.error
+                 << " pilot = " << selection.pilotEvaluations << endl;
+            return -1;
+        }
+        MCQMCSelection used;
+        MCQMCAdaptiveResult result = autoIntegrate(integrand, s, tolerance,
+                                                   budget, &used);
+        // selection depends on measured time, so it is compared with
+        // the one used
+        if (used.candidates.empty() || result.m != used.best.m
+            || result.N != used.best.N
+            || fabs(result.value - 1.0) > 1e-5) {
+            cout << "integrate" << setprecision(17) << endl;
+            cout << "result = " << result.value << " " << result.error
+                 << " m = " << result.m << " N = " << result.N << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_budget()
+    {
+        const uint32_t s = 5;
+        Integrand integrand(s);
+        MCQMCTolerance tolerance;
+        tolerance.maxEvaluations = UINT64_C(1) << 16;
+        MCQMCSelection selection = autoSelect(integrand, s, tolerance,
+                                              UINT64_C(1) << 16);
+        const MCQMCCandidate& best = selection.best;
+        uint64_t points = static_cast<uint64_t>(best.N) << best.m;
+        if (points > tolerance.maxEvaluations
+            || points < tolerance.maxEvaluations / 2) {
+            cout << "budget m = " << best.m << " N = " << best.N << endl;
+            return -1;
+        }
+        try {
+            autoSelect(integrand, s, MCQMCTolerance());
+            cout << "no target is accepted" << endl;
+            return -1;
+        } catch (...) {
+        }
+        return 0;
+    }
+
+    /*
+     * the target can't be met and there is no budget.
+     */
+    int test_unreachable()
+    {
+        const uint32_t s = 5;
+        Integrand integrand(s);
+        MCQMCTolerance tolerance(1e-300);
+        MCQMCSelection selection;
+        MCQMCAdaptiveResult result = autoIntegrate(integrand, s, tolerance,
+                                                   UINT64_C(1) << 16,
+                                                   &selection);
+        const MCQMCCandidate& best = selection.best;
+        if (selection.reachable || result.converged
+            || result.evaluations > UINT64_C(1) << 24
+            || result.evaluations != static_cast<uint64_t>(best.N) << best.m
+            || fabs(result.value - 1.0) > 1e-5) {
+            cout << "unreachable m = " << best.m << " N = " << best.N
+                 << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    /*
+     * budget less than the first pilot of any net.
+     */
+    int test_small_budget()
+    {
+        const uint32_t s = 5;
+        Integrand integrand(s);
+        MCQMCTolerance tolerance(1e-6);
+        try {
+            autoSelect(integrand, s, tolerance, 10);
+            cout << "pilot exceeds budget" << endl;
+            return -1;
+        } catch (const char *) {
+        }
+        return 0;
+    }
+
+    struct Failure {
+    };
+
+    class FailingIntegrand {
+    public:
+        FailingIntegrand(int s, uint64_t failAt) {
+            this->s = s;
+            this->failAt = failAt;
+        }
+        double operator()(const double p[]) {
+            if (failAt-- == 0) {
+                throw Failure();
+            }
+            return integrand_value(p, s);
+        }
+    private:
+        int s;
+        uint64_t failAt;
+    };
+
+    int test_failure()
+    {
+        const uint32_t s = 5;
+        FailingIntegrand integrand(s, 5000);
+        MCQMCTolerance tolerance(1e-6);
+        try {
+            autoSelect(integrand, s, tolerance, UINT64_C(1) << 18);
+        } catch (const Failure&) {
+            return 0;
+        }
+        cout << "failure of integrand is not reported" << endl;
+        return -1;
+    }
+}
+
+int main()
+{
+    if (test_target() != 0
+        || test_budget() != 0
+        || test_unreachable() != 0
+        || test_small_budget() != 0
+        || test_failure() != 0) {
+        return -1;
+    }
+    return 0;
+}
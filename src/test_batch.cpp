@@ -0,0 +1,206 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    double value(const double p[], size_t step, int s)
+    {
+        double r = 1.0;
+        for (int i = 0; i < s; i++) {
+            r *= 1.0 + (p[i * step] - 0.5) / (i + 1);
+        }
+        return r;
+    }
+
+    class AoSIntegrand {
+    public:
+        AoSIntegrand(int s) {
+            this->s = s;
+            calls = 0;
+        }
+        void operator()(const double * points, size_t n, size_t stride,
+                        double * out) {
+            calls++;
+            for (size_t i = 0; i < n; i++) {
+                out[i] = value(points + i * stride, 1, s);
+            }
+        }
+        int calls;
+    private:
+        int s;
+    };
+
+    class SoAIntegrand {
+    public:
+        static const BatchLayout batch_layout = BATCH_SOA;
+        SoAIntegrand(int s) {
+            this->s = s;
+            calls = 0;
+        }
+        // scalar form is also available, batch form is preferred
+        double operator()(const double p[]) {
+            return -value(p, 1, s);
+        }
+        void operator()(const double * points, size_t n, size_t stride,
+                        double * out) {
+            calls++;
+            for (size_t i = 0; i < n; i++) {
+                out[i] = value(points + i, stride, s);
+            }
+        }
+        int calls;
+    private:
+        int s;
+    };
+
+    double kvalue(const double p[], size_t step, int s, size_t k)
+    {
+        double r = 1.0;
+        for (int i = 0; i < s; i++) {
+            r *= 1.0 + (p[i * step] - 0.5) * (k + 1) / (i + 1);
+        }
+        return r;
+    }
+
+    class KIntegrand {
+    public:
+        KIntegrand(int s, size_t k) {
+            this->s = s;
+            this->k = k;
+        }
+        double operator()(const double p[]) {
+            return kvalue(p, 1, s, k);
+        }
+    private:
+        int s;
+        size_t k;
+    };
+
+    class VectorIntegrand {
+    public:
+        VectorIntegrand(int s, size_t K) {
+            this->s = s;
+            this->K = K;
+            calls = 0;
+        }
+        void operator()(const double p[], double out[]) {
+            calls++;
+            for (size_t k = 0; k < K; k++) {
+                out[k] = kvalue(p, 1, s, k);
+            }
+        }
+        int calls;
+    private:
+        int s;
+        size_t K;
+    };
+
+    class VectorSoAIntegrand {
+    public:
+        static const BatchLayout batch_layout = BATCH_SOA;
+        VectorSoAIntegrand(int s, size_t) {
+            this->s = s;
+            calls = 0;
+        }
+        void operator()(const double * points, size_t n, size_t stride,
+                        double * out, size_t K) {
+            calls++;
+            for (size_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < K; k++) {
+                    out[i * K + k] = kvalue(points + i, stride, s, k);
+                }
+            }
+        }
+        int calls;
+    private:
+        int s;
+    };
+
+    static_assert(!has_batch_operator<Integrand>::value, "scalar");
+    static_assert(!has_vector_batch_operator<VectorIntegrand>::value, "vec");
+    static_assert(has_vector_batch_operator<VectorSoAIntegrand>::value,
+                  "vec soa");
+    static_assert(has_batch_operator<AoSIntegrand>::value, "aos");
+    static_assert(has_batch_operator<SoAIntegrand>::value, "soa");
+    static_assert(batch_layout_of<AoSIntegrand>::value == BATCH_AOS, "aos");
+    static_assert(batch_layout_of<SoAIntegrand>::value == BATCH_SOA, "soa");
+
+    int check(const char * name, const MCQMCResult& result,
+              const MCQMCResult& expect, int calls)
+    {
+        if (calls == 0) {
+            cout << name << " batch is not called" << endl;
+            return -1;
+        }
+        return check(name, result, expect);
+    }
+
+    template<typename B>
+    int test_qmc(uint32_t s, uint32_t m, uint32_t N, const char * name)
+    {
+        Integrand integrand(s);
+        B batch(s);
+        DigitalNet<uint64_t> net1(SOBOL, s, m);
+        DigitalNet<uint64_t> net2(SOBOL, s, m);
+        MCQMCResult expect = quasi_monte_carlo_integration(N, integrand,
+                                                           net1);
+        MCQMCResult result = quasi_monte_carlo_integration(N, batch, net2);
+        return check(name, result, expect, batch.calls);
+    }
+
+    template<typename B>
+    int test_mc(uint32_t s, uint32_t m, uint32_t N, const char * name)
+    {
+        Integrand integrand(s);
+        B batch(s);
+        std::mt19937_64 mt1(1);
+        std::mt19937_64 mt2(1);
+        std::uniform_real_distribution<double> dist1(0.0, 1.0);
+        std::uniform_real_distribution<double> dist2(0.0, 1.0);
+        MCQMCResult expect = monte_carlo_integration(s, m, N, integrand,
+                                                     mt1, dist1);
+        MCQMCResult result = monte_carlo_integration(s, m, N, batch,
+                                                     mt2, dist2);
+        return check(name, result, expect, batch.calls);
+    }
+
+    template<typename V>
+    int test_vector(uint32_t s, uint32_t m, uint32_t N, const char * name)
+    {
+        const size_t K = 3;
+        V vec(s, K);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        vector<MCQMCResult> result
+            = vector_quasi_monte_carlo_integration(N, K, vec, net);
+        for (size_t k = 0; k < K; k++) {
+            KIntegrand integrand(s, k);
+            DigitalNet<uint64_t> single(SOBOL, s, m);
+            MCQMCResult expect = quasi_monte_carlo_integration(N, integrand,
+                                                               single);
+            if (check(name, result[k], expect, vec.calls) != 0) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_qmc<AoSIntegrand>(4, 12, 5, "qmc aos") != 0
+        || test_qmc<SoAIntegrand>(4, 12, 5, "qmc soa") != 0
+        || test_qmc<AoSIntegrand>(20, 6, 1, "qmc aos small") != 0
+        || test_qmc<SoAIntegrand>(20, 6, 1, "qmc soa small") != 0
+        || test_mc<AoSIntegrand>(5, 3000, 4, "mc aos") != 0
+        || test_mc<SoAIntegrand>(5, 3000, 4, "mc soa") != 0
+        || test_vector<VectorIntegrand>(4, 10, 5, "vector") != 0
+        || test_vector<VectorSoAIntegrand>(6, 12, 3, "vector soa") != 0) {
+        return -1;
+    }
+    return 0;
+}
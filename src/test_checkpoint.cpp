@@ -0,0 +1,187 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <cmath>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    const char * path = "test_checkpoint.ckp";
+
+    struct Interrupted {
+    };
+
+    // throws after limit calls, as the process is killed.
+    class LimitedIntegrand {
+    public:
+        LimitedIntegrand(int s, uint64_t limit = UINT64_MAX) {
+            this->s = s;
+            this->limit = limit;
+            calls = 0;
+        }
+        double operator()(const double p[]) {
+            if (limit-- == 0) {
+                throw Interrupted();
+            }
+            calls++;
+            return integrand_value(p, s);
+        }
+        uint64_t calls;
+    private:
+        int s;
+        uint64_t limit;
+    };
+
+    class BatchIntegrand {
+    public:
+        BatchIntegrand(int s, uint64_t limit = UINT64_MAX) {
+            this->s = s;
+            this->limit = limit;
+            calls = 0;
+        }
+        void operator()(const double * points, size_t n, size_t stride,
+                        double * out) {
+            if (limit < n) {
+                throw Interrupted();
+            }
+            limit -= n;
+            calls += n;
+            for (size_t i = 0; i < n; i++) {
+                out[i] = integrand_value(points + i * stride, s);
+            }
+        }
+        uint64_t calls;
+    private:
+        int s;
+        uint64_t limit;
+    };
+
+    bool exists()
+    {
+        ifstream ifs(path);
+        return static_cast<bool>(ifs);
+    }
+
+    int test_state()
+    {
+        DigitalNet<uint64_t> net(SOBOL, 6, 10);
+        DigitalNet<uint64_t> other(SOBOL, 6, 10);
+        net.setDigitalShift(true);
+        net.pointInitialize();
+        for (int i = 0; i < 1500; i++) {
+            net.nextPoint();
+        }
+        stringstream ss;
+        net.saveState(ss);
+        if (!other.restoreState(ss)) {
+            cout << "can't restore state" << endl;
+            return -1;
+        }
+        // following points and shifts of next randomizations
+        for (int i = 0; i < 3000; i++) {
+            for (int j = 0; j < 6; j++) {
+                if (net.getPoint(j) != other.getPoint(j)) {
+                    cout << "point differs at " << i << endl;
+                    return -1;
+                }
+            }
+            net.nextPoint();
+            other.nextPoint();
+        }
+        // other base matrix of the same s and m
+        DigitalNet<uint64_t> scrambled(SOBOL, 6, 10);
+        scrambled.linearScramble();
+        stringstream ss2;
+        net.saveState(ss2);
+        if (scrambled.restoreState(ss2)) {
+            cout << "state of other net is restored" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    template<typename T>
+    int test_resume(uint64_t limit, const char * name)
+    {
+        const uint32_t s = 5;
+        const uint32_t m = 10;
+        const uint32_t N = 6;
+        remove(path);
+        T plain(s);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        MCQMCResult expect = quasi_monte_carlo_integration(N, plain, net);
+
+        CheckpointConfig config(path, 0);
+        config.intervalPoints = 300;
+        T first(s, limit);
+        DigitalNet<uint64_t> net1(SOBOL, s, m);
+        try {
+            quasi_monte_carlo_integration(N, first, net1, config);
+            cout << name << " not interrupted" << endl;
+            return -1;
+        } catch (Interrupted&) {
+        }
+        if (!exists()) {
+            cout << name << " no checkpoint" << endl;
+            return -1;
+        }
+        T second(s);
+        DigitalNet<uint64_t> net2(SOBOL, s, m);
+        MCQMCResult result = quasi_monte_carlo_integration(N, second, net2,
+                                                           config);
+        if (check(name, result, expect) != 0) {
+            return -1;
+        }
+        // points before the last checkpoint are not evaluated again
+        if (second.calls >= (static_cast<uint64_t>(N) << m)) {
+            cout << name << " not resumed" << endl;
+            return -1;
+        }
+        if (exists()) {
+            cout << name << " checkpoint is not removed" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_mismatch()
+    {
+        const uint32_t s = 5;
+        const uint32_t m = 10;
+        remove(path);
+        CheckpointConfig config(path, 0);
+        config.intervalPoints = 500;
+        LimitedIntegrand first(s, 2000);
+        DigitalNet<uint64_t> net1(SOBOL, s, m);
+        try {
+            quasi_monte_carlo_integration(4, first, net1, config);
+        } catch (Interrupted&) {
+        }
+        // checkpoint of other N is not used
+        LimitedIntegrand plain(s);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        MCQMCResult expect = quasi_monte_carlo_integration(3, plain, net);
+        LimitedIntegrand second(s);
+        DigitalNet<uint64_t> net2(SOBOL, s, m);
+        MCQMCResult result = quasi_monte_carlo_integration(3, second, net2,
+                                                           config);
+        remove(path);
+        return check("mismatch", result, expect);
+    }
+}
+
+int main()
+{
+    if (test_state() != 0
+        || test_resume<LimitedIntegrand>(2500, "scalar") != 0
+        || test_resume<LimitedIntegrand>(1024, "boundary") != 0
+        || test_resume<BatchIntegrand>(3500, "batch") != 0
+        || test_mismatch() != 0) {
+        return -1;
+    }
+    return 0;
+}
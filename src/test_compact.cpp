@@ -0,0 +1,100 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <MCQMCIntegration/DigitalNet.h>
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    bool same_points(DigitalNet<uint64_t>& x, DigitalNet<uint64_t>& y)
+    {
+        x.pointInitialize();
+        y.pointInitialize();
+        for (uint64_t k = 0; k < (UINT64_C(1) << x.getM()); k++) {
+            for (uint32_t i = 0; i < x.getS(); i++) {
+                if (x.getPoint(i) != y.getPoint(i)) {
+                    return false;
+                }
+            }
+            x.nextPoint();
+            y.nextPoint();
+        }
+        return true;
+    }
+
+    bool same_base(const DigitalNet<uint64_t>& x,
+                   const DigitalNet<uint64_t>& y)
+    {
+        if (x.getS() != y.getS() || x.getM() != y.getM()) {
+            return false;
+        }
+        for (uint32_t i = 0; i < x.getM(); i++) {
+            for (uint32_t j = 0; j < x.getS(); j++) {
+                if (x.getBase(i, j) != y.getBase(i, j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    int test_compact(DigitalNetID id, uint32_t s, uint32_t m)
+    {
+        DigitalNet<uint64_t> full(id, s, m);
+        DigitalNet<uint64_t> compact(id, s, m);
+        // points are made from upper 53 bits
+        compact.setCompact(53);
+        if (!same_points(full, compact)) {
+            cout << "compact points id = " << id << endl;
+            return -1;
+        }
+        stringstream ss;
+        compact.writeCompact(ss, 64);
+        DigitalNet<uint64_t> read(ss);
+        if (!same_base(full, read) || !same_points(full, read)
+            || read.getTvalue() != full.getTvalue()) {
+            cout << "compact round trip id = " << id << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_layout()
+    {
+        DigitalNet<uint64_t> net(SOBOL, 4, 10);
+        stringstream ss;
+        net.writeCompact(ss, 64);
+        string data = ss.str();
+        // magic, then version and s as 32-bit, all little endian
+        const unsigned char expect[] = {0x42, 0x72, 0xb6, 0x82,
+                                        0x1d, 0x95, 0xb5, 0x36,
+                                        1, 0, 0, 0, 4, 0, 0, 0,
+                                        10, 0, 0, 0, 64, 0, 0, 0};
+        for (size_t i = 0; i < sizeof(expect); i++) {
+            if (static_cast<unsigned char>(data[i]) != expect[i]) {
+                cout << "layout i = " << i << endl;
+                return -1;
+            }
+        }
+        // truncated data
+        stringstream truncated(data.substr(0, data.size() - 8));
+        try {
+            DigitalNet<uint64_t> bad(truncated);
+        } catch (const char *) {
+            return 0;
+        }
+        cout << "truncated compact data is accepted" << endl;
+        return -1;
+    }
+}
+
+int main()
+{
+    if (test_compact(SOBOL, 10, 12) != 0
+        || test_compact(ISOBOL_A3, 6, 11) != 0
+        || test_layout() != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <unistd.h>
+#include <MCQMCIntegration/DigitalNet.h>
+#include "embedded_data.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace MCQMCIntegration {
+    // defined in DigitalNet.cpp, the 32-bit loader
+    int readDigitalNetData(DigitalNetID id, uint32_t s, uint32_t m,
+                           uint32_t base[],
+                           int64_t * tvalue, double * wafom);
+}
+
+namespace {
+    bool same_base(const DigitalNet<uint64_t>& net, const uint64_t data[])
+    {
+        for (uint32_t i = 0; i < net.getM(); i++) {
+            for (uint32_t j = 0; j < net.getS(); j++) {
+                if (net.getBase(i, j) != data[i * net.getS() + j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    int test_sobol(const vector<uint64_t>& expect, uint32_t s, uint32_t m)
+    {
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        if (!same_base(net, &expect[0])) {
+            cout << "embedded sobol differs" << endl;
+            return -1;
+        }
+        vector<uint32_t> base(expect.size());
+        int64_t tvalue = -1;
+        double wafom = 0;
+        if (readDigitalNetData(SOBOL, s, m, &base[0], &tvalue, &wafom) != 0) {
+            cout << "32-bit sobol is not loaded" << endl;
+            return -1;
+        }
+        for (size_t i = 0; i < base.size(); i++) {
+            if (base[i] != static_cast<uint32_t>(expect[i] >> 32)) {
+                cout << "32-bit sobol differs i = " << i << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    int test_nets()
+    {
+        for (size_t k = 0; k < embedded_nets_size; k++) {
+            const embedded_net_t& e = embedded_nets[k];
+            DigitalNetID id = static_cast<DigitalNetID>(e.id);
+            if (e.bitsize == 64) {
+                DigitalNet<uint64_t> net(id, e.s, e.m);
+                if (!same_base(net, e.data) || net.getTvalue() != e.tvalue) {
+                    cout << "embedded net differs k = " << k << endl;
+                    return -1;
+                }
+                continue;
+            }
+            vector<uint32_t> base(static_cast<size_t>(e.s) * e.m);
+            int64_t tvalue = -1;
+            double wafom = 0;
+            if (readDigitalNetData(id, e.s, e.m, &base[0], &tvalue, &wafom)
+                != 0 || tvalue != e.tvalue) {
+                cout << "32-bit embedded net is not loaded k = " << k << endl;
+                return -1;
+            }
+            for (size_t i = 0; i < base.size(); i++) {
+                if (base[i] != static_cast<uint32_t>(e.data[i])) {
+                    cout << "32-bit embedded net differs k = " << k << endl;
+                    return -1;
+                }
+            }
+        }
+        return 0;
+    }
+
+    int test_ranges()
+    {
+        for (size_t i = 0; i < embedded_complete_ids_size; i++) {
+            DigitalNetID id
+                = static_cast<DigitalNetID>(embedded_complete_ids[i]);
+            uint32_t s_min = getSMin(id);
+            uint32_t s_max = getSMax(id);
+            for (size_t k = 0; k < embedded_nets_size; k++) {
+                const embedded_net_t& e = embedded_nets[k];
+                if (e.id != embedded_complete_ids[i]) {
+                    continue;
+                }
+                if (e.s < s_min || e.s > s_max
+                    || e.m < getMMin(id, e.s) || e.m > getMMax(id, e.s)) {
+                    cout << "range of id = " << id << " s = " << e.s
+                         << " m = " << e.m << endl;
+                    return -1;
+                }
+            }
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    const uint32_t s = 8;
+    const uint32_t m = 10;
+    vector<uint64_t> expect;
+    {
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        for (uint32_t i = 0; i < m; i++) {
+            for (uint32_t j = 0; j < s; j++) {
+                expect.push_back(net.getBase(i, j));
+            }
+        }
+    }
+    uint32_t s_max = getSMax(SOBOL);
+    uint32_t m_max = getMMax(SOBOL, s);
+    char dir[] = "/tmp/test_embeddedXXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        cout << "can't make directory" << endl;
+        return -1;
+    }
+    setenv("DIGITAL_NET_PATH", dir, 1);
+    int r = 0;
+    if (test_sobol(expect, s, m) != 0 || test_nets() != 0
+        || test_ranges() != 0) {
+        r = -1;
+    } else if (getSMax(SOBOL) != s_max || getMMax(SOBOL, s) != m_max) {
+        cout << "sobol range differs" << endl;
+        r = -1;
+    } else {
+        // data directory is really empty
+        try {
+            DigitalNet<uint64_t> net(ISOBOL_A2, 4, 10);
+            cout << "net is read from empty directory" << endl;
+            r = -1;
+        } catch (const char *) {
+        }
+    }
+    rmdir(dir);
+    return r;
+}
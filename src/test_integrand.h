@@ -0,0 +1,79 @@
+#pragma once
+#ifndef TEST_INTEGRAND_H
+#define TEST_INTEGRAND_H
+/**
+ * @file test_integrand.h
+ *
+ * @brief integrand and comparison of results used by tests.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+
+namespace {
+    /*
+     * product of 1 + (p[i] - 0.5) / (i + 1), whose integral is 1.
+     */
+    inline double integrand_value(const double p[], int s)
+    {
+        double r = 1.0;
+        for (int i = 0; i < s; i++) {
+            r *= 1.0 + (p[i] - 0.5) / (i + 1);
+        }
+        return r;
+    }
+
+    class Integrand {
+    public:
+        Integrand(int s) {
+            this->s = s;
+        }
+        double operator()(const double p[]) {
+            return integrand_value(p, s);
+        }
+    private:
+        int s;
+    };
+
+    /*
+     * the same value and error, error is NaN when N = 1.
+     */
+    inline bool same(const MCQMCIntegration::MCQMCResult& x,
+                     const MCQMCIntegration::MCQMCResult& y)
+    {
+        return x.value == y.value
+            && (x.error == y.error
+                || (std::isnan(x.error) && std::isnan(y.error)));
+    }
+
+    /*
+     * print both results if they are not the same.
+     */
+    inline int check(const char * name,
+                     const MCQMCIntegration::MCQMCResult& result,
+                     const MCQMCIntegration::MCQMCResult& expect)
+    {
+        if (!same(result, expect)) {
+            std::cout << name << std::setprecision(17) << std::endl;
+            std::cout << "result = " << result.value << " "
+                      << result.error << std::endl;
+            std::cout << "expected = " << expect.value << " "
+                      << expect.error << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+#endif // TEST_INTEGRAND_H
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    int test_points(DigitalNetID id, uint32_t s, uint32_t m)
+    {
+        DigitalNet<uint64_t> eager(id, s, m);
+        DigitalNet<uint64_t> lazy(id, s, m, true);
+        if (lazy.getMaterializedS() >= s) {
+            cout << "not lazy id = " << id << endl;
+            return -1;
+        }
+        // a coordinate makes dimensions up to its chunk of 64
+        double x = lazy.getPoint(70);
+        if (lazy.getMaterializedS() != 128 || x != eager.getPoint(70)) {
+            cout << "chunk id = " << id
+                 << " made = " << lazy.getMaterializedS() << endl;
+            return -1;
+        }
+        DigitalNet<uint64_t> lazy2(id, s, m, true);
+        for (uint64_t k = 0; k < (UINT64_C(1) << m); k++) {
+            const double * p = eager.getPoint();
+            const double * q = lazy2.getPoint();
+            for (uint32_t i = 0; i < s; i++) {
+                if (p[i] != q[i]) {
+                    cout << "points id = " << id << " k = " << k
+                         << " i = " << i << setprecision(17) << " "
+                         << p[i] << " " << q[i] << endl;
+                    return -1;
+                }
+            }
+            eager.nextPoint();
+            lazy2.nextPoint();
+        }
+        return 0;
+    }
+
+    int test_integration(DigitalNetID id, uint32_t s, uint32_t m)
+    {
+        Integrand integrand(s);
+        DigitalNet<uint64_t> eager(id, s, m);
+        DigitalNet<uint64_t> lazy(id, s, m, true);
+        MCQMCResult expect = quasi_monte_carlo_integration(3, integrand,
+                                                           eager);
+        MCQMCResult result = quasi_monte_carlo_integration(3, integrand,
+                                                           lazy);
+        if (result.value != expect.value || result.error != expect.error) {
+            cout << "integration id = " << id << setprecision(17) << endl;
+            cout << "result = " << result.value << " "
+                 << result.error << endl;
+            cout << "expected = " << expect.value << " "
+                 << expect.error << endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    // Sobol nets of small s are compiled in and never lazy
+    if (test_points(SOBOL, 600, 10) != 0
+        || test_points(ISOBOL_A2, 150, 10) != 0
+        || test_integration(SOBOL, 600, 10) != 0
+        || test_integration(ISOBOL_A3, 150, 10) != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <MCQMCIntegration/DigitalNetLoader.h>
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    // larger than maximum dimension of Sobol point set
+    const uint32_t too_large = 100000;
+
+    bool same(const DigitalNet<uint64_t>& x, const DigitalNet<uint64_t>& y)
+    {
+        if (x.getS() != y.getS() || x.getM() != y.getM()) {
+            return false;
+        }
+        for (uint32_t i = 0; i < x.getM(); i++) {
+            for (uint32_t j = 0; j < x.getS(); j++) {
+                if (x.getBase(i, j) != y.getBase(i, j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    int test_async()
+    {
+        future<DigitalNetPtr> f = loadDigitalNetAsync(SOBOL, 5, 10);
+        future<DigitalNetPtr> lazy = loadDigitalNetAsync(SOBOL, 600, 10,
+                                                         true);
+        future<DigitalNetPtr> bad = loadDigitalNetAsync(SOBOL, too_large,
+                                                        10);
+        DigitalNet<uint64_t> expect(SOBOL, 5, 10);
+        if (!same(*f.get(), expect)
+            || lazy.get()->getMaterializedS() >= 600) {
+            cout << "async" << endl;
+            return -1;
+        }
+        try {
+            bad.get();
+        } catch (...) {
+            return 0;
+        }
+        cout << "async error is not reported" << endl;
+        return -1;
+    }
+
+    int test_warmup()
+    {
+        DigitalNetConfig configs[] = {{SOBOL, 5, 10},
+                                      {SOBOL, too_large, 10},
+                                      {ISOBOL_A2, 4, 12},
+                                      {SOBOL, 8, 11}};
+        const size_t size = sizeof(configs) / sizeof(configs[0]);
+        DigitalNetWarmup warmup(vector<DigitalNetConfig>(configs,
+                                                         configs + size),
+                                2);
+        vector<bool> seen(size, false);
+        size_t index;
+        DigitalNetPtr net;
+        int errors = 0;
+        for (;;) {
+            try {
+                if (!warmup.next(&index, &net)) {
+                    break;
+                }
+            } catch (...) {
+                errors++;
+                continue;
+            }
+            DigitalNet<uint64_t> expect(configs[index].id, configs[index].s,
+                                        configs[index].m);
+            if (seen[index] || !same(*net, expect)) {
+                cout << "warmup next index = " << index << endl;
+                return -1;
+            }
+            seen[index] = true;
+        }
+        if (errors != 1 || !seen[0] || seen[1] || !seen[2] || !seen[3]) {
+            cout << "warmup errors = " << errors << endl;
+            return -1;
+        }
+        try {
+            warmup.get(1);
+            cout << "warmup error is not reported" << endl;
+            return -1;
+        } catch (...) {
+        }
+        if (!same(*warmup.get(3), DigitalNet<uint64_t>(SOBOL, 8, 11))) {
+            cout << "warmup get" << endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_async() != 0
+        || test_warmup() != 0) {
+        return -1;
+    }
+    return 0;
+}
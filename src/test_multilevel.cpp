@@ -0,0 +1,135 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <MCQMCIntegration/Multilevel.h>
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    const uint32_t dims[] = {4, 8, 16};
+
+    /*
+     * P_l uses first dims[l] coordinates, expectation of P_l is 1.
+     */
+    double approx(const double p[], uint32_t s)
+    {
+        double r = 1.0;
+        for (uint32_t i = 0; i < s; i++) {
+            r *= 1.0 + (p[i] - 0.5) / ((i + 1) * (i + 1));
+        }
+        return r;
+    }
+
+    class Multilevel {
+    public:
+        Multilevel() {
+            calls.resize(3);
+        }
+        double operator()(uint32_t level, const double p[]) {
+            calls[level]++;
+            if (level == 0) {
+                return approx(p, dims[0]);
+            }
+            return approx(p, dims[level]) - approx(p, dims[level - 1]);
+        }
+        vector<uint64_t> calls;
+    };
+
+    int test_target()
+    {
+        Multilevel integrand;
+        vector<uint32_t> dimensions(dims, dims + 3);
+        MCQMCTolerance tolerance(1e-5);
+        vector<double> costs = {1, 2, 4};
+        MLQMCResult result = multilevel_quasi_monte_carlo_integration(
+            integrand, SOBOL, dimensions, tolerance, costs);
+        uint64_t calls = 0;
+        for (size_t l = 0; l < 3; l++) {
+            calls += integrand.calls[l];
+            if (integrand.calls[l] != result.levels[l].evaluations
+                || result.levels[l].s != dims[l]) {
+                cout << "level " << l << " calls = " << integrand.calls[l]
+                     << " evaluations = " << result.levels[l].evaluations
+                     << endl;
+                return -1;
+            }
+        }
+        if (!result.converged || result.error > 1e-5
+            || fabs(result.value - 1.0) > 3e-5
+            || calls != result.evaluations) {
+            cout << "target" << setprecision(17) << endl;
+            cout << "result = " << result.value << " " << result.error
+                 << " converged = " << result.converged << endl;
+            return -1;
+        }
+        // coarse level has the largest variance and the smallest cost
+        if (result.levels[0].evaluations <= result.levels[2].evaluations) {
+            cout << "allocation " << result.levels[0].evaluations << " "
+                 << result.levels[2].evaluations << endl;
+            return -1;
+        }
+        // given costs make the allocation reproducible
+        Multilevel again;
+        MLQMCResult result2 = multilevel_quasi_monte_carlo_integration(
+            again, SOBOL, dimensions, tolerance, costs);
+        if (result2.value != result.value || result2.error != result.error) {
+            cout << "not reproducible" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_budget()
+    {
+        Multilevel integrand;
+        vector<uint32_t> dimensions(dims, dims + 3);
+        MCQMCTolerance tolerance(1e-12);
+        tolerance.maxEvaluations = 100000;
+        MLQMCResult result = multilevel_quasi_monte_carlo_integration(
+            integrand, SOBOL, dimensions, tolerance);
+        if (result.converged || result.evaluations > 100000) {
+            cout << "budget evaluations = " << result.evaluations << endl;
+            return -1;
+        }
+        // the first evaluation is in the budget
+        tolerance.minM = 10;
+        tolerance.maxM = 10;
+        tolerance.minTrials = 8;
+        tolerance.maxEvaluations = 3 * 3 << 10;
+        result = multilevel_quasi_monte_carlo_integration(
+            integrand, SOBOL, dimensions, tolerance);
+        if (result.evaluations != tolerance.maxEvaluations
+            || result.levels[0].N != 3) {
+            cout << "first budget evaluations = " << result.evaluations
+                 << endl;
+            return -1;
+        }
+        tolerance.maxEvaluations = 3 << 10;
+        try {
+            multilevel_quasi_monte_carlo_integration(
+                integrand, SOBOL, dimensions, tolerance);
+            cout << "too small budget is accepted" << endl;
+            return -1;
+        } catch (...) {
+        }
+        try {
+            multilevel_quasi_monte_carlo_integration(
+                integrand, SOBOL, dimensions, MCQMCTolerance());
+            cout << "no target is accepted" << endl;
+            return -1;
+        } catch (...) {
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_target() != 0
+        || test_budget() != 0) {
+        return -1;
+    }
+    return 0;
+}
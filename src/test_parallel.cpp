@@ -0,0 +1,113 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    struct test_data_t {
+        uint32_t s;
+        uint32_t m;
+        uint32_t N;
+        bool scramble;
+    };
+
+    test_data_t test_data[] = {
+        {4, 10, 10, false},
+        {8, 12, 7, true},
+        {20, 8, 1, false},
+    };
+
+    bool same(double x, double y)
+    {
+        // error is NaN when N = 1
+        return x == y || (std::isnan(x) && std::isnan(y));
+    }
+
+    int test(ThreadPool& pool)
+    {
+        size_t size = sizeof(test_data) / sizeof(test_data_t);
+        for (size_t i = 0; i < size; i++) {
+            const test_data_t& t = test_data[i];
+            Integrand integrand(t.s);
+            DigitalNet<uint64_t> serialNet(SOBOL, t.s, t.m);
+            DigitalNet<uint64_t> parallelNet(SOBOL, t.s, t.m);
+            if (t.scramble) {
+                serialNet.setSeed(1);
+                serialNet.linearScramble();
+                parallelNet.setSeed(1);
+                parallelNet.linearScramble();
+            }
+            MCQMCResult expect
+                = quasi_monte_carlo_integration(t.N, integrand, serialNet);
+            MCQMCResult result
+                = parallel_quasi_monte_carlo_integration(
+                    t.N, [&]() { return integrand; }, parallelNet, pool);
+            if (!same(result.value, expect.value)
+                || !same(result.error, expect.error)) {
+                cout << "s = " << t.s << " m = " << t.m
+                     << " N = " << t.N << endl;
+                cout << setprecision(17);
+                cout << "result = " << result.value << " "
+                     << result.error << endl;
+                cout << "expected = " << expect.value << " "
+                     << expect.error << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    int test_stealing(ThreadPool& pool, ThreadPool& single)
+    {
+        size_t size = sizeof(test_data) / sizeof(test_data_t);
+        for (size_t i = 0; i < size; i++) {
+            const test_data_t& t = test_data[i];
+            Integrand integrand(t.s);
+            DigitalNet<uint64_t> serialNet(SOBOL, t.s, t.m + 4);
+            DigitalNet<uint64_t> singleNet(SOBOL, t.s, t.m + 4);
+            DigitalNet<uint64_t> stealingNet(SOBOL, t.s, t.m + 4);
+            MCQMCResult expect
+                = quasi_monte_carlo_integration(t.N, integrand, serialNet);
+            MCQMCResult one
+                = stealing_quasi_monte_carlo_integration(
+                    t.N, [&]() { return integrand; }, singleNet, single);
+            MCQMCResult result
+                = stealing_quasi_monte_carlo_integration(
+                    t.N, [&]() { return integrand; }, stealingNet, pool);
+            // independent of number of threads
+            if (!same(result.value, one.value)
+                || !same(result.error, one.error)
+                || fabs(result.value - expect.value) > 1e-12) {
+                cout << "stealing s = " << t.s << " m = " << t.m + 4
+                     << " N = " << t.N << endl;
+                cout << setprecision(17);
+                cout << "result = " << result.value << " "
+                     << result.error << endl;
+                cout << "single = " << one.value << " "
+                     << one.error << endl;
+                cout << "expected = " << expect.value << " "
+                     << expect.error << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    ThreadPool pool(4);
+    // the pool is reused
+    if (test(pool) != 0) {
+        return -1;
+    }
+    if (test(pool) != 0) {
+        return -1;
+    }
+    ThreadPool single(1);
+    return test_stealing(pool, single);
+}
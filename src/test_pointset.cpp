@@ -0,0 +1,212 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdlib>
+#include <cstdio>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#include <MCQMCIntegration/PointSetCache.h>
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    const uint32_t s = 4;
+    const uint32_t m = 10;
+
+    vector<string> list_files(const string& dir)
+    {
+        vector<string> files;
+        DIR * d = opendir(dir.c_str());
+        if (d == NULL) {
+            return files;
+        }
+        struct dirent * ent;
+        while ((ent = readdir(d)) != NULL) {
+            string name = ent->d_name;
+            if (name != "." && name != "..") {
+                files.push_back(dir + "/" + name);
+            }
+        }
+        closedir(d);
+        return files;
+    }
+
+    void set_mtime(const string& path, time_t t)
+    {
+        struct utimbuf times;
+        times.actime = t;
+        times.modtime = t;
+        utime(path.c_str(), &times);
+    }
+
+    void shifted(DigitalNet<uint64_t>& net, uint64_t seed)
+    {
+        net.setSeed(seed);
+        net.setDigitalShift(true);
+        net.pointInitialize();
+    }
+
+    /*
+     * compare with a net of the same shift, pointInitialize() of
+     * shifted net makes a new shift.
+     */
+    bool same_points(uint64_t seed, const MappedPointSet& set)
+    {
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        shifted(net, seed);
+        vector<double> point(s);
+        for (uint64_t k = 0; k < set.size(); k++) {
+            set.getPoint(k, &point[0]);
+            for (uint32_t j = 0; j < s; j++) {
+                if (net.getPoint(j) != point[j]) {
+                    return false;
+                }
+            }
+            net.nextPoint();
+        }
+        return true;
+    }
+
+    int test_hit(const string& dir)
+    {
+        PointSetCache cache(dir);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        shifted(net, 1);
+        shared_ptr<const MappedPointSet> first = cache.get(net);
+        shared_ptr<const MappedPointSet> second = cache.get(net);
+        if (cache.getHits() != 1 || cache.getMisses() != 1) {
+            cout << "hit hits = " << cache.getHits()
+                 << " misses = " << cache.getMisses() << endl;
+            return -1;
+        }
+        if (!same_points(1, *second)) {
+            cout << "points differ" << endl;
+            return -1;
+        }
+        cache.get(net, POINT_INTEGER);
+        if (cache.getMisses() != 2) {
+            cout << "format is not a part of key" << endl;
+            return -1;
+        }
+        shared_ptr<const MappedPointSet> integer
+            = cache.get(net, POINT_INTEGER);
+        if (cache.getHits() != 2 || !same_points(1, *integer)) {
+            cout << "integer points differ" << endl;
+            return -1;
+        }
+        cache.clear();
+        return 0;
+    }
+
+    int test_eviction(const string& dir)
+    {
+        DigitalNet<uint64_t> a(SOBOL, s, m);
+        DigitalNet<uint64_t> b(SOBOL, s, m);
+        DigitalNet<uint64_t> c(SOBOL, s, m);
+        shifted(a, 1);
+        shifted(b, 2);
+        shifted(c, 3);
+        PointSetCache probe(dir);
+        probe.get(a);
+        vector<string> files = list_files(dir);
+        if (files.size() != 1) {
+            cout << "number of files = " << files.size() << endl;
+            return -1;
+        }
+        ifstream ifs(files[0].c_str(), ios::binary | ios::ate);
+        uint64_t size = ifs.tellg();
+        ifs.close();
+        // room for two files
+        PointSetCache cache(dir, size * 2 + size / 2);
+        string file_a = files[0];
+        cache.get(b);
+        files = list_files(dir);
+        string file_b = files[0] == file_a ? files[1] : files[0];
+        // a is the least recently used, and removed by c
+        time_t now = time(NULL);
+        set_mtime(file_a, now - 100);
+        set_mtime(file_b, now - 50);
+        cache.get(c);
+        files = list_files(dir);
+        if (files.size() != 2 || access(file_a.c_str(), F_OK) == 0
+            || access(file_b.c_str(), F_OK) != 0) {
+            cout << "least recently used file is not removed" << endl;
+            return -1;
+        }
+        cache.get(b);
+        cache.get(a);
+        if (cache.getHits() != 1 || cache.getMisses() != 3) {
+            cout << "eviction hits = " << cache.getHits()
+                 << " misses = " << cache.getMisses() << endl;
+            return -1;
+        }
+        cache.clear();
+        return 0;
+    }
+
+    int test_corrupt(const string& dir)
+    {
+        PointSetCache cache(dir);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        shifted(net, 1);
+        cache.get(net);
+        string path = list_files(dir)[0];
+        // broken magic
+        {
+            fstream fs(path.c_str(), ios::in | ios::out | ios::binary);
+            fs.seekp(0);
+            fs.put(0);
+        }
+        shared_ptr<const MappedPointSet> set = cache.get(net);
+        if (cache.getMisses() != 2 || !same_points(1, *set)) {
+            cout << "broken header is accepted" << endl;
+            return -1;
+        }
+        set.reset();
+        // truncated
+        if (truncate(path.c_str(), 100) != 0) {
+            cout << "can't truncate" << endl;
+            return -1;
+        }
+        set = cache.get(net);
+        if (cache.getMisses() != 3 || !same_points(1, *set)) {
+            cout << "truncated file is accepted" << endl;
+            return -1;
+        }
+        set.reset();
+        cache.clear();
+        // directory does not exist
+        PointSetCache missing(dir + "/none");
+        try {
+            missing.get(net);
+            cout << "no exception" << endl;
+            return -1;
+        } catch (const char *) {
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    char dir[] = "/tmp/test_pointsetXXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        cout << "can't make directory" << endl;
+        return -1;
+    }
+    int r = 0;
+    if (test_hit(dir) != 0 || test_eviction(dir) != 0
+        || test_corrupt(dir) != 0) {
+        r = -1;
+    }
+    vector<string> files = list_files(dir);
+    for (size_t i = 0; i < files.size(); i++) {
+        remove(files[i].c_str());
+    }
+    rmdir(dir);
+    return r;
+}
@@ -0,0 +1,157 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    // global state, as legacy simulators
+    uint64_t global_calls = 0;
+
+    class FailingIntegrand {
+    public:
+        FailingIntegrand(int s, uint64_t failAt = UINT64_MAX) {
+            this->s = s;
+            this->failAt = failAt;
+        }
+        double operator()(const double p[]) {
+            if (global_calls++ == failAt) {
+                throw "failure";
+            }
+            return integrand_value(p, s);
+        }
+    private:
+        int s;
+        uint64_t failAt;
+    };
+
+    int test_pool()
+    {
+        ProcessPool pool(3);
+        vector<uint64_t> results(100);
+        pool.run(results.size(), sizeof(uint64_t),
+                 [](unsigned, size_t index, void * result) {
+                     *static_cast<uint64_t *>(result) = index * index;
+                 }, &results[0]);
+        for (size_t i = 0; i < results.size(); i++) {
+            if (results[i] != i * i) {
+                cout << "pool result " << i << " = " << results[i] << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    int test_same(uint32_t s, uint32_t m, uint32_t N, unsigned processes)
+    {
+        FailingIntegrand integrand(s);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        MCQMCResult expect = quasi_monte_carlo_integration(N, integrand, net);
+        global_calls = 0;
+        ProcessPool pool(processes);
+        DigitalNet<uint64_t> net2(SOBOL, s, m);
+        MCQMCResult result = process_quasi_monte_carlo_integration(
+            N, integrand, net2, pool);
+        // integrand ran in other processes
+        if (result.value != expect.value || result.error != expect.error
+            || global_calls != 0) {
+            cout << "same s = " << s << " processes = " << processes
+                 << setprecision(17) << endl;
+            cout << "result = " << result.value << " "
+                 << result.error << endl;
+            cout << "expected = " << expect.value << " "
+                 << expect.error << endl;
+            cout << "calls = " << global_calls << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_split()
+    {
+        const uint32_t s = 6;
+        const uint32_t m = 12;
+        const uint32_t N = 3;
+        FailingIntegrand integrand(s);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        MCQMCResult expect = quasi_monte_carlo_integration(N, integrand, net);
+        vector<MCQMCResult> results;
+        for (unsigned p = 1; p <= 4; p += 3) {
+            ProcessPool pool(p);
+            DigitalNet<uint64_t> net2(SOBOL, s, m);
+            results.push_back(process_quasi_monte_carlo_integration(
+                                  N, integrand, net2, pool, 99, 8));
+        }
+        if (results[0].value != results[1].value
+            || fabs(results[0].value - expect.value) > 1e-12) {
+            cout << "split" << setprecision(17) << endl;
+            cout << "results = " << results[0].value << " "
+                 << results[1].value << endl;
+            cout << "expected = " << expect.value << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    /*
+     * jobs do not change the net of the caller, which is left as
+     * shifts are drawn, and lazy net is accepted.
+     */
+    int test_state()
+    {
+        const uint32_t s = 4;
+        const uint32_t N = 3;
+        DigitalNet<uint64_t> net(ISOBOL_A2, s, 10, true);
+        DigitalNet<uint64_t> twin(ISOBOL_A2, s, 10);
+        FailingIntegrand integrand(s);
+        ProcessPool pool(2);
+        process_quasi_monte_carlo_integration(N, integrand, net, pool);
+        vector<uint64_t> shifts;
+        qmc_draw_shifts(twin, N, shifts);
+        for (int k = 0; k < 3; k++) {
+            for (uint32_t i = 0; i < s; i++) {
+                if (net.getPoint(i) != twin.getPoint(i)
+                    || net.getShift()[i] != twin.getShift()[i]) {
+                    cout << "state is changed k = " << k << endl;
+                    return -1;
+                }
+            }
+            net.nextPoint();
+            twin.nextPoint();
+        }
+        return 0;
+    }
+
+    int test_failure()
+    {
+        // workers start from the count of the caller
+        global_calls = 0;
+        FailingIntegrand integrand(4, 100);
+        ProcessPool pool(2);
+        DigitalNet<uint64_t> net(SOBOL, 4, 10);
+        try {
+            process_quasi_monte_carlo_integration(4, integrand, net, pool);
+        } catch (...) {
+            return 0;
+        }
+        cout << "failure is not reported" << endl;
+        return -1;
+    }
+}
+
+int main()
+{
+    if (test_pool() != 0
+        || test_same(5, 10, 7, 3) != 0
+        || test_same(3, 11, 2, 8) != 0
+        || test_split() != 0
+        || test_state() != 0
+        || test_failure() != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    int test_each_randomization()
+    {
+        const uint32_t s = 5;
+        const uint32_t m = 10;
+        Integrand integrand(s);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        MCQMCResult expect = quasi_monte_carlo_integration(6, integrand, net);
+        vector<MCQMCProgress> reports;
+        ProgressObserver observer([&reports](const MCQMCProgress& progress) {
+                reports.push_back(progress);
+                return true;
+            });
+        DigitalNet<uint64_t> net2(SOBOL, s, m);
+        MCQMCResult result = quasi_monte_carlo_integration(6, integrand,
+                                                           net2, observer);
+        if (check("not stopped", result, expect) != 0) {
+            return -1;
+        }
+        if (reports.size() != 5) {
+            cout << "reports = " << reports.size() << endl;
+            return -1;
+        }
+        for (size_t i = 0; i < reports.size(); i++) {
+            if (reports[i].trials != i + 1
+                || reports[i].points != (i + 1) << m) {
+                cout << "report " << i << " trials = " << reports[i].trials
+                     << " points = " << reports[i].points << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    int test_stop()
+    {
+        const uint32_t s = 5;
+        const uint32_t m = 10;
+        Integrand integrand(s);
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        MCQMCResult expect = quasi_monte_carlo_integration(3, integrand, net);
+        ProgressObserver observer([](const MCQMCProgress& progress) {
+                return progress.trials < 3;
+            });
+        DigitalNet<uint64_t> net2(SOBOL, s, m);
+        MCQMCResult result = quasi_monte_carlo_integration(10, integrand,
+                                                           net2, observer);
+        return check("stop", result, expect);
+    }
+
+    int test_interval()
+    {
+        const uint32_t s = 5;
+        const uint32_t m = 10;
+        Integrand integrand(s);
+        // mean of the first 300 points, before a randomization is done
+        DigitalNet<uint64_t> net(SOBOL, s, m);
+        net.setDigitalShift(true);
+        net.pointInitialize();
+        BlockVariance sum;
+        for (int i = 0; i < 300; i++) {
+            sum.addData(integrand(net.getPoint()));
+            net.nextPoint();
+        }
+        MCQMCResult expect({sum.getMean(), sum.absErr(99)});
+        uint64_t points = 0;
+        ProgressObserver observer([&points](const MCQMCProgress& progress) {
+                points = progress.points;
+                return false;
+            }, 300);
+        DigitalNet<uint64_t> net2(SOBOL, s, m);
+        MCQMCResult result = quasi_monte_carlo_integration(10, integrand,
+                                                           net2, observer);
+        if (points != 300) {
+            cout << "points = " << points << endl;
+            return -1;
+        }
+        return check("interval", result, expect);
+    }
+}
+
+int main()
+{
+    if (test_each_randomization() != 0
+        || test_stop() != 0
+        || test_interval() != 0) {
+        return -1;
+    }
+    return 0;
+}
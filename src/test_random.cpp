@@ -0,0 +1,184 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <random>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    int test_sequence()
+    {
+        uint64_t seeds[] = {5489, 0, 1234567, UINT64_C(0xffffffffffffffff)};
+        for (size_t i = 0; i < sizeof(seeds) / sizeof(uint64_t); i++) {
+            std::mt19937_64 expect(seeds[i]);
+            MersenneTwister64 mt(seeds[i]);
+            for (int j = 0; j < 10000; j++) {
+                if (mt() != expect()) {
+                    cout << "sequence seed = " << seeds[i]
+                         << " j = " << j << endl;
+                    return -1;
+                }
+            }
+        }
+        return 0;
+    }
+
+    int test_jump()
+    {
+        uint64_t steps[] = {0, 1, 311, 312, 1000, 123457};
+        for (size_t i = 0; i < sizeof(steps) / sizeof(uint64_t); i++) {
+            MersenneTwister64 jumped(4321);
+            jumped();
+            std::mt19937_64 expect(4321);
+            expect.discard(steps[i] + 1);
+            jumped.jump(steps[i]);
+            for (int j = 0; j < 1000; j++) {
+                if (jumped() != expect()) {
+                    cout << "jump steps = " << steps[i]
+                         << " j = " << j << endl;
+                    return -1;
+                }
+            }
+        }
+        // jump of 2^40 twice equals jump of 2^41
+        MersenneTwister64 a(1);
+        MersenneTwister64 b(1);
+        MTJumpPolynomial poly(UINT64_C(1) << 40);
+        poly.apply(a);
+        poly.apply(a);
+        b.jump(UINT64_C(1) << 41);
+        if (a != b) {
+            cout << "jump 2^41" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_block()
+    {
+        std::mt19937_64 expect(777);
+        MTBlockRandom block(777);
+        std::vector<uint64_t> raw(1000);
+        // mixed calls cross block boundaries
+        for (int k = 0; k < 5; k++) {
+            for (int j = 0; j < 100; j++) {
+                if (block() != expect()) {
+                    cout << "block operator() k = " << k << endl;
+                    return -1;
+                }
+            }
+            block.fill(&raw[0], raw.size());
+            for (size_t j = 0; j < raw.size(); j++) {
+                if (raw[j] != expect()) {
+                    cout << "block fill k = " << k << endl;
+                    return -1;
+                }
+            }
+        }
+        std::vector<double> x(777);
+        block.fill(&x[0], x.size());
+        for (size_t j = 0; j < x.size(); j++) {
+            double e = static_cast<double>(expect() >> 11) * exp2(-53);
+            if (x[j] != e || x[j] < 0 || x[j] >= 1) {
+                cout << "block double j = " << j << endl;
+                return -1;
+            }
+        }
+        // from jumped generator
+        MersenneTwister64 mt(5);
+        mt.jump(100000);
+        MTBlockRandom jumped(mt);
+        for (int j = 0; j < 1000; j++) {
+            if (jumped() != mt()) {
+                cout << "block jumped j = " << j << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * the conversion of MTBlockRandom::fill()
+     */
+    class Canonical53 {
+    public:
+        template<typename R>
+        double operator()(R& rand) {
+            return static_cast<double>(rand() >> 11) * exp2(-53);
+        }
+    };
+
+    int test_block_mc()
+    {
+        uint32_t s = 7;
+        uint32_t m = 5000;
+        uint32_t N = 6;
+        Integrand integrand(s);
+        std::mt19937_64 mt(31);
+        Canonical53 dist;
+        MCQMCResult expect = monte_carlo_integration(s, m, N, integrand,
+                                                     mt, dist);
+        MTBlockRandom block(31);
+        MCQMCResult result = monte_carlo_integration(s, m, N, integrand,
+                                                     block);
+        if (result.value != expect.value || result.error != expect.error
+            || block() != mt()) {
+            cout << "block mc" << setprecision(17) << endl;
+            cout << "result = " << result.value << " "
+                 << result.error << endl;
+            cout << "expected = " << expect.value << " "
+                 << expect.error << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_parallel_mc()
+    {
+        uint32_t s = 6;
+        uint32_t m = 1000;
+        ThreadPool pools[] = {ThreadPool(1), ThreadPool(3), ThreadPool(8)};
+        uint32_t Ns[] = {1, 7, 20};
+        for (size_t k = 0; k < sizeof(Ns) / sizeof(uint32_t); k++) {
+            uint32_t N = Ns[k];
+            Integrand integrand(s);
+            std::mt19937_64 expect_mt(99);
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+            MCQMCResult expect = monte_carlo_integration(s, m, N, integrand,
+                                                         expect_mt, dist);
+            for (size_t i = 0; i < 3; i++) {
+                MersenneTwister64 mt(99);
+                MCQMCResult result = parallel_monte_carlo_integration(
+                    s, m, N, [&]() { return integrand; }, mt, dist,
+                    pools[i]);
+                // the generator is advanced as the serial version
+                std::mt19937_64 next(expect_mt);
+                if (!same(result, expect) || mt() != next()) {
+                    cout << "parallel mc N = " << N << " threads = "
+                         << pools[i].size() << setprecision(17) << endl;
+                    cout << "result = " << result.value << " "
+                         << result.error << endl;
+                    cout << "expected = " << expect.value << " "
+                         << expect.error << endl;
+                    return -1;
+                }
+            }
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_sequence() != 0
+        || test_jump() != 0
+        || test_parallel_mc() != 0
+        || test_block() != 0
+        || test_block_mc() != 0) {
+        return -1;
+    }
+    return 0;
+}
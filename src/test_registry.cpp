@@ -0,0 +1,109 @@
+#include <iostream>
+#include <MCQMCIntegration/DigitalNetRegistry.h>
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    int check(DigitalNetRegistry& registry, uint64_t hits, uint64_t misses,
+              size_t size, const char * msg)
+    {
+        if (registry.getHits() != hits || registry.getMisses() != misses
+            || registry.size() != size) {
+            cout << msg << " hits = " << registry.getHits()
+                 << " misses = " << registry.getMisses()
+                 << " size = " << registry.size() << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_hit()
+    {
+        DigitalNetRegistry registry(2);
+        SharedDigitalNet a = registry.get(SOBOL, 4, 10);
+        if (check(registry, 0, 1, 1, "first get") != 0) {
+            return -1;
+        }
+        if (registry.get(SOBOL, 4, 10) != a
+            || check(registry, 1, 1, 1, "second get") != 0) {
+            cout << "net is not shared" << endl;
+            return -1;
+        }
+        // seed is ignored without scramble
+        if (registry.get(SOBOL, 4, 10, false, 123) != a) {
+            cout << "seed without scramble makes new net" << endl;
+            return -1;
+        }
+        SharedDigitalNet scrambled = registry.get(SOBOL, 4, 10, true, 123);
+        if (scrambled == a || check(registry, 2, 2, 2, "scramble") != 0) {
+            cout << "scrambled net is shared with original" << endl;
+            return -1;
+        }
+        if (a->getBase(0, 0) == scrambled->getBase(0, 0)
+            && a->getBase(1, 1) == scrambled->getBase(1, 1)) {
+            cout << "net is not scrambled" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_eviction()
+    {
+        DigitalNetRegistry registry(2);
+        SharedDigitalNet a = registry.get(SOBOL, 4, 10);
+        SharedDigitalNet b = registry.get(SOBOL, 5, 10);
+        // a becomes most recently used, b is evicted by c
+        registry.get(SOBOL, 4, 10);
+        registry.get(SOBOL, 6, 10);
+        if (check(registry, 1, 3, 2, "eviction") != 0) {
+            return -1;
+        }
+        if (registry.get(SOBOL, 4, 10) != a
+            || check(registry, 2, 3, 2, "after eviction") != 0) {
+            cout << "recently used net is evicted" << endl;
+            return -1;
+        }
+        if (registry.get(SOBOL, 5, 10) == b
+            || check(registry, 2, 4, 2, "evicted net") != 0) {
+            cout << "least recently used net is not evicted" << endl;
+            return -1;
+        }
+        registry.setCapacity(1);
+        if (check(registry, 2, 4, 1, "shrink") != 0) {
+            return -1;
+        }
+        registry.setCapacity(0);
+        registry.get(SOBOL, 4, 10);
+        if (check(registry, 2, 5, 0, "capacity zero") != 0) {
+            return -1;
+        }
+        registry.setCapacity(2);
+        registry.get(SOBOL, 4, 10);
+        registry.clear();
+        if (check(registry, 2, 6, 0, "clear") != 0) {
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_error()
+    {
+        DigitalNetRegistry registry(2);
+        try {
+            registry.get(SOBOL, 100000, 10);
+            cout << "no exception" << endl;
+            return -1;
+        } catch (const char *) {
+        }
+        return check(registry, 0, 1, 0, "error");
+    }
+}
+
+int main()
+{
+    if (test_hit() != 0 || test_eviction() != 0 || test_error() != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include "mapped_file.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    /*
+     * stream buffer which can not seek, like pipe
+     */
+    class PipeBuffer : public streambuf {
+    public:
+        PipeBuffer(const string& data) : data(data) {
+            pos = 0;
+        }
+    protected:
+        int_type underflow() {
+            if (pos == data.size()) {
+                return traits_type::eof();
+            }
+            // one character at a time
+            ch = data[pos++];
+            setg(&ch, &ch, &ch + 1);
+            return traits_type::to_int_type(ch);
+        }
+    private:
+        string data;
+        size_t pos;
+        char ch;
+    };
+
+    int fail(const char * name)
+    {
+        cout << name << endl;
+        return -1;
+    }
+
+    int test_range()
+    {
+        // range is not NUL terminated, last token ends at last
+        string text = "12 +34\n 5 6789";
+        vector<char> data(text.begin(), text.end());
+        const char * first = &data[0];
+        TextScanner scanner(first, first + data.size() - 2);
+        uint64_t x[4];
+        if (!scanner.next(x[0]) || !scanner.next(x[1])
+            || !scanner.next(x[2]) || !scanner.next(x[3])
+            || x[0] != 12 || x[1] != 34 || x[2] != 5 || x[3] != 67
+            || scanner.next(x[0]) || !scanner.atEnd()) {
+            return fail("range");
+        }
+        return 0;
+    }
+
+    int test_truncated()
+    {
+        string text = "64 3 2\n1 2 3\n4 5";
+        TextScanner scanner(text.data(), text.data() + text.size());
+        uint64_t x;
+        int count = 0;
+        while (scanner.next(x)) {
+            count++;
+        }
+        if (count != 8 || !scanner.atEnd()) {
+            return fail("truncated");
+        }
+        return 0;
+    }
+
+    int test_line()
+    {
+        string text = "1 2\n3";
+        TextScanner scanner(text.data(), text.data() + text.size());
+        uint64_t x;
+        if (!scanner.next(x, false) || !scanner.next(x, false)
+            || scanner.next(x, false)) {
+            return fail("line");
+        }
+        scanner.skipLine();
+        if (!scanner.next(x, false) || x != 3) {
+            return fail("skip line");
+        }
+        return 0;
+    }
+
+    int test_values()
+    {
+        string text = "18446744073709551615 18446744073709551616";
+        TextScanner scanner(text.data(), text.data() + text.size());
+        uint64_t u;
+        int64_t i;
+        double d;
+        if (!scanner.next(u) || u != UINT64_MAX) {
+            return fail("max");
+        }
+        if (scanner.next(u)) {
+            return fail("overflow");
+        }
+        string text2 = "-9 0.25 1e-3 abc";
+        TextScanner scanner2(text2.data(), text2.data() + text2.size());
+        if (!scanner2.next(i) || i != -9) {
+            return fail("negative");
+        }
+        if (!scanner2.next(d) || d != 0.25
+            || !scanner2.next(d) || d != 1e-3) {
+            return fail("double");
+        }
+        if (scanner2.next(d) || scanner2.next(u) || scanner2.atEnd()) {
+            return fail("not a number");
+        }
+        return 0;
+    }
+
+    int test_stream()
+    {
+        PipeBuffer pipe("64 2 1\n 7 +8 0.5 -1\nend 9");
+        istream is(&pipe);
+        StreamScanner scanner(is);
+        uint64_t u[5];
+        double w;
+        int64_t t;
+        for (int k = 0; k < 5; k++) {
+            if (!scanner.next(u[k])) {
+                return fail("stream");
+            }
+        }
+        if (u[0] != 64 || u[3] != 7 || u[4] != 8
+            || !scanner.next(w) || w != 0.5
+            || !scanner.next(t) || t != -1) {
+            return fail("stream values");
+        }
+        // not a number is left in the stream
+        if (scanner.next(t)) {
+            return fail("stream end");
+        }
+        string rest;
+        getline(is, rest);
+        if (rest != "end 9") {
+            cout << "rest = " << rest << endl;
+            return fail("stream rest");
+        }
+        return 0;
+    }
+
+    int test_stream_line()
+    {
+        PipeBuffer pipe("1\n2");
+        istream is(&pipe);
+        StreamScanner scanner(is);
+        uint64_t x;
+        if (!scanner.next(x, false) || scanner.next(x, false)
+            || !scanner.next(x) || x != 2 || scanner.next(x)) {
+            return fail("stream line");
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_range() != 0
+        || test_truncated() != 0
+        || test_line() != 0
+        || test_values() != 0
+        || test_stream() != 0
+        || test_stream_line() != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <MCQMCIntegration/IntegrationScheduler.h>
+#include "test_integrand.h"
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    /*
+     * blocks a worker until open() is called.
+     */
+    class Gate {
+    public:
+        Gate() {
+            closed = true;
+        }
+        void pass() {
+            unique_lock<mutex> lock(mtx);
+            while (closed) {
+                cond.wait(lock);
+            }
+        }
+        void open() {
+            unique_lock<mutex> lock(mtx);
+            closed = false;
+            cond.notify_all();
+        }
+    private:
+        mutex mtx;
+        condition_variable cond;
+        bool closed;
+    };
+
+    int test_results()
+    {
+        ThreadPool pool(4);
+        IntegrationScheduler scheduler(pool);
+        uint32_t dims[] = {3, 5, 3, 8, 3, 5};
+        vector<future<MCQMCResult> > futures;
+        for (size_t i = 0; i < sizeof(dims) / sizeof(uint32_t); i++) {
+            Integrand integrand(dims[i]);
+            futures.push_back(scheduler.submit(
+                                  integrand,
+                                  IntegrationConfig(SOBOL, dims[i], 10, 5)));
+        }
+        for (size_t i = 0; i < futures.size(); i++) {
+            Integrand integrand(dims[i]);
+            DigitalNet<uint64_t> net(SOBOL, dims[i], 10);
+            MCQMCResult expect = quasi_monte_carlo_integration(5, integrand,
+                                                               net);
+            MCQMCResult result = futures[i].get();
+            if (!same(result, expect)) {
+                cout << "result i = " << i << setprecision(17) << endl;
+                cout << "result = " << result.value << " "
+                     << result.error << endl;
+                cout << "expected = " << expect.value << " "
+                     << expect.error << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    int test_priority_cancel()
+    {
+        ThreadPool pool(1);
+        IntegrationScheduler scheduler(pool);
+        Gate gate;
+        pool.post([&](unsigned) { gate.pass(); });
+        mutex mtx;
+        vector<int> order;
+        vector<future<MCQMCResult> > futures;
+        vector<IntegrationScheduler::JobID> ids;
+        int priorities[] = {0, 5, 1, 5};
+        for (int i = 0; i < 4; i++) {
+            IntegrationConfig config(SOBOL, 2 + i, 4, 2);
+            config.priority = priorities[i];
+            IntegrationScheduler::JobID id;
+            futures.push_back(scheduler.submitRunner(
+                                  [&, i](DigitalNet<uint64_t>&) {
+                                      unique_lock<mutex> lock(mtx);
+                                      order.push_back(i);
+                                      return MCQMCResult({0.0, 0.0});
+                                  }, config, &id));
+            ids.push_back(id);
+        }
+        if (scheduler.pending() != 4 || !scheduler.cancel(ids[2])
+            || scheduler.cancel(ids[2])) {
+            cout << "cancel" << endl;
+            return -1;
+        }
+        gate.open();
+        scheduler.wait();
+        try {
+            futures[2].get();
+            cout << "cancelled job returns" << endl;
+            return -1;
+        } catch (const runtime_error&) {
+        }
+        int expect[] = {1, 3, 0};
+        if (order.size() != 3 || scheduler.cancel(ids[0])) {
+            cout << "order size = " << order.size() << endl;
+            return -1;
+        }
+        for (size_t i = 0; i < 3; i++) {
+            if (order[i] != expect[i]) {
+                cout << "order " << i << " " << order[i] << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * jobs of the same net are not run serially by one worker.
+     */
+    int test_parallel_batch()
+    {
+        ThreadPool pool(4);
+        IntegrationScheduler scheduler(pool);
+        mutex mtx;
+        set<thread::id> workers;
+        vector<future<MCQMCResult> > futures;
+        for (int i = 0; i < 8; i++) {
+            futures.push_back(scheduler.submitRunner(
+                                  [&](DigitalNet<uint64_t>&) {
+                                      this_thread::sleep_for(
+                                          chrono::milliseconds(20));
+                                      unique_lock<mutex> lock(mtx);
+                                      workers.insert(this_thread::get_id());
+                                      return MCQMCResult({0.0, 0.0});
+                                  }, IntegrationConfig(SOBOL, 4, 10, 2)));
+        }
+        scheduler.wait();
+        if (workers.size() < 2) {
+            cout << "workers = " << workers.size() << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    /*
+     * a job of higher priority submitted later runs before waiting jobs
+     * of the same net as the running job.
+     */
+    int test_batch_priority()
+    {
+        ThreadPool pool(1);
+        IntegrationScheduler scheduler(pool);
+        Gate gate;
+        pool.post([&](unsigned) { gate.pass(); });
+        mutex mtx;
+        vector<int> order;
+        IntegrationConfig low(SOBOL, 4, 10, 2);
+        IntegrationConfig high(SOBOL, 5, 10, 2);
+        high.priority = 5;
+        IntegrationScheduler::Runner record2 = [&](DigitalNet<uint64_t>&) {
+            unique_lock<mutex> lock(mtx);
+            order.push_back(2);
+            return MCQMCResult({0.0, 0.0});
+        };
+        scheduler.submitRunner([&](DigitalNet<uint64_t>&) {
+                scheduler.submitRunner(record2, high);
+                unique_lock<mutex> lock(mtx);
+                order.push_back(0);
+                return MCQMCResult({0.0, 0.0});
+            }, low);
+        scheduler.submitRunner([&](DigitalNet<uint64_t>&) {
+                unique_lock<mutex> lock(mtx);
+                order.push_back(1);
+                return MCQMCResult({0.0, 0.0});
+            }, low);
+        gate.open();
+        scheduler.wait();
+        int expect[] = {0, 2, 1};
+        if (order.size() != 3) {
+            cout << "batch order size = " << order.size() << endl;
+            return -1;
+        }
+        for (size_t i = 0; i < 3; i++) {
+            if (order[i] != expect[i]) {
+                cout << "batch order " << i << " " << order[i] << endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    int test_running_cancel()
+    {
+        ThreadPool pool(2);
+        IntegrationScheduler scheduler(pool);
+        Gate started;
+        IntegrationConfig config(SOBOL, 4, 10, 100000);
+        config.observer = ProgressObserver(
+            [&started](const MCQMCProgress&) {
+                started.open();
+                return true;
+            });
+        IntegrationScheduler::JobID id;
+        future<MCQMCResult> f = scheduler.submit(Integrand(4), config, &id);
+        started.pass();
+        if (!scheduler.cancel(id)) {
+            cout << "can't cancel running job" << endl;
+            return -1;
+        }
+        MCQMCResult partial = f.get();
+        if (std::isnan(partial.value) || scheduler.cancel(id)) {
+            cout << "partial = " << partial.value << endl;
+            return -1;
+        }
+        // observer of config stops the job
+        IntegrationConfig three(SOBOL, 4, 10, 10);
+        three.observer = ProgressObserver(
+            [](const MCQMCProgress& progress) {
+                return progress.trials < 3;
+            });
+        MCQMCResult result = scheduler.submit(Integrand(4), three).get();
+        Integrand integrand(4);
+        DigitalNet<uint64_t> net(SOBOL, 4, 10);
+        MCQMCResult expect = quasi_monte_carlo_integration(3, integrand, net);
+        if (!same(result, expect)) {
+            cout << "stopped by observer" << setprecision(17) << endl;
+            cout << "result = " << result.value << " "
+                 << result.error << endl;
+            cout << "expected = " << expect.value << " "
+                 << expect.error << endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_results() != 0
+        || test_priority_cancel() != 0
+        || test_parallel_batch() != 0
+        || test_batch_priority() != 0
+        || test_running_cancel() != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "config.h"
+#include <iostream>
+#include <string>
+#include <MCQMCIntegration/DigitalNet.h>
+#if defined(HAVE_SHM_OPEN) && defined(HAVE_SYS_MMAN_H)
+#include <dirent.h>
+#include <unistd.h>
+#include <sstream>
+#endif
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    bool same(const DigitalNet<uint64_t>& x, const DigitalNet<uint64_t>& y)
+    {
+        if (x.getS() != y.getS() || x.getM() != y.getM()
+            || x.getTvalue() != y.getTvalue()) {
+            return false;
+        }
+        for (uint32_t i = 0; i < x.getM(); i++) {
+            for (uint32_t j = 0; j < x.getS(); j++) {
+                if (x.getBase(i, j) != y.getBase(i, j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*
+     * number of files of segments in /dev/shm, -1 if it can't be read.
+     */
+    int segments()
+    {
+#if defined(HAVE_SHM_OPEN) && defined(HAVE_SYS_MMAN_H)
+        DIR * dir = opendir("/dev/shm");
+        if (dir == NULL) {
+            return -1;
+        }
+        stringstream ss;
+        ss << "mcqmcint." << getuid() << ".";
+        string prefix = ss.str();
+        int count = 0;
+        for (struct dirent * e = readdir(dir); e != NULL; e = readdir(dir)) {
+            if (string(e->d_name).compare(0, prefix.size(), prefix) == 0) {
+                count++;
+            }
+        }
+        closedir(dir);
+        return count;
+#else
+        return -1;
+#endif
+    }
+
+    int test_share()
+    {
+        removeSharedMemoryCache(SOBOL, 7, 12);
+        removeSharedMemoryCache(ISOBOL_A2, 5, 11);
+        int before = segments();
+        DigitalNet<uint64_t> local(SOBOL, 7, 12);
+        DigitalNet<uint64_t> local2(ISOBOL_A2, 5, 11);
+        setSharedMemoryCache(true);
+        // first one publishes, second one attaches
+        DigitalNet<uint64_t> first(SOBOL, 7, 12);
+        DigitalNet<uint64_t> second(SOBOL, 7, 12);
+        DigitalNet<uint64_t> third(ISOBOL_A2, 5, 11);
+        if (!same(local, first) || !same(local, second)
+            || !same(local2, third)) {
+            cout << "share" << endl;
+            return -1;
+        }
+        int published = segments();
+        // failure of loading leaves no segment
+        try {
+            DigitalNet<uint64_t> bad(SOBOL, 100000, 12);
+            cout << "failure is not reported" << endl;
+            return -1;
+        } catch (const char *) {
+        }
+        if (before >= 0 && (published != before + 2
+                            || segments() != published)) {
+            cout << "segments = " << before << " " << published << " "
+                 << segments() << endl;
+            return -1;
+        }
+        bool removed = removeSharedMemoryCache(SOBOL, 7, 12);
+        removeSharedMemoryCache(ISOBOL_A2, 5, 11);
+        // objects which map removed segment are not affected
+        DigitalNet<uint64_t> fourth(SOBOL, 7, 12);
+        if (!same(local, second) || !same(local, fourth)) {
+            cout << "after remove" << endl;
+            return -1;
+        }
+        removeSharedMemoryCache(SOBOL, 7, 12);
+        setSharedMemoryCache(false);
+        if (before >= 0 && (!removed || segments() != before)) {
+            cout << "remove segments = " << segments() << endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_share() != 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cmath>
+#include <MCQMCIntegration/DigitalNet.h>
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    /*
+     * stream buffer which can not seek, like pipe
+     */
+    class PipeBuffer : public streambuf {
+    public:
+        PipeBuffer(const string& data) : data(data) {
+            pos = 0;
+        }
+    protected:
+        int_type underflow() {
+            if (pos == data.size()) {
+                return traits_type::eof();
+            }
+            size_t n = data.size() - pos < 7 ? data.size() - pos : 7;
+            setg(&data[pos], &data[pos], &data[pos] + n);
+            pos += n;
+            return traits_type::to_int_type(*gptr());
+        }
+    private:
+        string data;
+        size_t pos;
+    };
+
+    bool same(const DigitalNet<uint64_t>& x, uint32_t s, uint32_t m,
+              uint64_t first)
+    {
+        if (x.getS() != s || x.getM() != m) {
+            return false;
+        }
+        for (uint32_t i = 0; i < m; i++) {
+            for (uint32_t j = 0; j < s; j++) {
+                if (x.getBase(i, j) != first + i * s + j) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    string text_net(uint32_t s, uint32_t m, uint64_t first)
+    {
+        stringstream ss;
+        ss << "64 " << s << " " << m << "\n";
+        for (uint32_t i = 0; i < m; i++) {
+            for (uint32_t j = 0; j < s; j++) {
+                ss << first + i * s + j << " ";
+            }
+            ss << "\n";
+        }
+        ss << "0.125 3\n";
+        return ss.str();
+    }
+
+    int test_pipe()
+    {
+        stringstream compact;
+        {
+            stringstream ss(text_net(5, 4, 100));
+            DigitalNet<uint64_t> net(ss);
+            net.writeCompact(compact, 64);
+        }
+        PipeBuffer pipe(text_net(4, 3, 1) + text_net(2, 5, 50)
+                        + compact.str() + "rest\n");
+        istream is(&pipe);
+        DigitalNet<uint64_t> first(is);
+        DigitalNet<uint64_t> second(is);
+        DigitalNet<uint64_t> third(is);
+        string rest;
+        is >> rest;
+        if (!same(first, 4, 3, 1) || !same(second, 2, 5, 50)
+            || !same(third, 5, 4, 100)
+            || first.getWAFOM() != 0.125 || second.getTvalue() != 3
+            || third.getWAFOM() != 0.125 || third.getTvalue() != 3
+            || rest != "rest") {
+            cout << "pipe rest = " << rest << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_truncated()
+    {
+        string text = text_net(4, 3, 1);
+        stringstream ss(text.substr(0, text.find("9 ")));
+        try {
+            DigitalNet<uint64_t> net(ss);
+        } catch (const char *) {
+            return 0;
+        }
+        cout << "truncated data is accepted" << endl;
+        return -1;
+    }
+}
+
+int main()
+{
+    if (test_pipe() != 0
+        || test_truncated() != 0) {
+        return -1;
+    }
+    return 0;
+}
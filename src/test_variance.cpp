@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <random>
+#include <MCQMCIntegration/MCQMCIntegration.h>
+
+using namespace MCQMCIntegration;
+using namespace std;
+
+namespace {
+    bool close(double x, double y)
+    {
+        return fabs(x - y) <= 1e-12 * max(1.0, fabs(y));
+    }
+
+    template<typename A, typename B>
+    int compare(const char * name, const A& a, const B& b)
+    {
+        if (a.getN() != b.getN()
+            || !close(a.getMean(), b.getMean())
+            || !close(a.unbiasedVar(), b.unbiasedVar())
+            || !close(a.absErr(99), b.absErr(99))) {
+            cout << name << setprecision(17) << endl;
+            cout << "n = " << a.getN() << " " << b.getN() << endl;
+            cout << "mean = " << a.getMean() << " " << b.getMean() << endl;
+            cout << "var = " << a.unbiasedVar() << " "
+                 << b.unbiasedVar() << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_merge()
+    {
+        std::mt19937_64 mt(1);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        std::vector<double> data(10000);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = 100.0 + dist(mt);
+        }
+        OnlineVariance all;
+        for (size_t i = 0; i < data.size(); i++) {
+            all.addData(data[i]);
+        }
+        // uneven shards, including an empty one
+        size_t bounds[] = {0, 1, 1, 37, 5000, 10000};
+        OnlineVariance merged;
+        for (size_t k = 0; k + 1 < sizeof(bounds) / sizeof(size_t); k++) {
+            OnlineVariance part;
+            for (size_t i = bounds[k]; i < bounds[k + 1]; i++) {
+                part.addData(data[i]);
+            }
+            merged.merge(part);
+        }
+        if (compare("merge", merged, all) != 0) {
+            return -1;
+        }
+        BlockVariance block;
+        for (size_t i = 0; i < data.size(); i++) {
+            block.addData(data[i]);
+        }
+        return compare("block", block, all);
+    }
+
+    int test_serialize()
+    {
+        OnlineVariance var;
+        var.addData(1.5);
+        var.addData(-2.25);
+        var.addData(7.0);
+        uint8_t buffer[OnlineVariance::serialized_size];
+        var.serialize(buffer);
+        OnlineVariance copy;
+        if (!copy.deserialize(buffer, sizeof(buffer))
+            || copy.getN() != var.getN()
+            || copy.getMean() != var.getMean()
+            || copy.unbiasedVar() != var.unbiasedVar()) {
+            cout << "serialize" << endl;
+            return -1;
+        }
+        OnlineVariance other;
+        buffer[0] ^= 1;
+        if (other.deserialize(buffer, sizeof(buffer))
+            || other.deserialize(buffer, sizeof(buffer) - 1)
+            || other.getN() != 0) {
+            cout << "deserialize invalid" << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    int test_count()
+    {
+        // counts over 2^31 are kept
+        OnlineVariance var;
+        var.addData(1.0);
+        var.addData(3.0);
+        uint8_t buffer[OnlineVariance::serialized_size];
+        var.serialize(buffer);
+        buffer[8] = 0;
+        buffer[12] = 1;
+        OnlineVariance large;
+        large.deserialize(buffer, sizeof(buffer));
+        OnlineVariance sum;
+        sum.merge(large);
+        sum.merge(large);
+        if (sum.getN() != INT64_C(1) << 33 || sum.getMean() != 2.0) {
+            cout << "count n = " << sum.getN() << endl;
+            return -1;
+        }
+        return 0;
+    }
+}
+
+int main()
+{
+    if (test_merge() != 0
+        || test_serialize() != 0
+        || test_count() != 0) {
+        return -1;
+    }
+    return 0;
+}